@@ -15,12 +15,15 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "aoc/arena.h"
 #include "aoc/io.h"
 #include "aoc/macros.h"
 #include "aoc/math.h"
 #include "aoc/parser.h"
 #include "aoc/point.h"
+#include "aoc/pool.h"
 #include "aoc/string.h"
+#include "aoc/time.h"
 #include "aoc/types.h"
 
 #include "log.h"
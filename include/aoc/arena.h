@@ -0,0 +1,116 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "aoc/macros.h"
+
+/**
+ * A bump allocator.
+ *
+ * Memory is carved out of large blocks and is never freed individually;
+ * aoc_arena_reset() releases everything at once in O(1) and keeps the blocks
+ * for reuse. An arena must only be used by one thread at a time.
+ */
+typedef struct AocArena AocArena;
+
+/* Default block size of aoc_arena_create(). */
+#define AOC_ARENA_BLOCK_SIZE (1 << 20)
+
+/**
+ * Creates an arena which allocates blocks of (at least) `block_size` bytes,
+ * or AOC_ARENA_BLOCK_SIZE if `block_size` is 0.
+ *
+ * @return The arena or NULL on error.
+ */
+AocArena *aoc_arena_create(size_t block_size);
+
+/**
+ * Releases the arena and all memory allocated from it.
+ * Suitable for use with _cleanup_().
+ */
+void aoc_arena_destroy(AocArena **arena);
+
+/**
+ * Allocates `size` bytes aligned to 16 bytes. Aborts if out of memory.
+ */
+void *aoc_arena_alloc(AocArena *arena, size_t size);
+
+/**
+ * Resizes an allocation of `old_size` bytes. The most recent allocation is
+ * resized in place if possible, all others are copied.
+ */
+void *aoc_arena_realloc(AocArena *arena, void *ptr, size_t old_size, size_t new_size);
+
+/**
+ * Releases all allocations of the arena at once.
+ */
+void aoc_arena_reset(AocArena *arena);
+
+/**
+ * The arena the CTL containers of the calling thread allocate from, or NULL
+ * to use malloc().
+ */
+extern _Thread_local AocArena *aoc_arena_current;
+
+/**
+ * Makes `arena` the current arena of the calling thread.
+ *
+ * @return The previous one.
+ */
+static inline AocArena *aoc_arena_use(AocArena *arena) {
+    AocArena *prev = aoc_arena_current;
+    aoc_arena_current = arena;
+    return prev;
+}
+
+static inline void aoc_arena_scope_end(AocArena **prev) { aoc_arena_current = *prev; }
+
+/**
+ * Makes `arena` the current arena until the end of the enclosing block.
+ *
+ * Containers must be freed under the same arena they were created under, so
+ * declare them after ARENA_SCOPE() in the same block: their _cleanup_() then
+ * runs before the previous arena is restored. Freeing a container of an arena
+ * is a no-op; its memory is released by aoc_arena_reset() or
+ * aoc_arena_destroy().
+ */
+#define ARENA_SCOPE(arena) _cleanup_(aoc_arena_scope_end) _unused_ AocArena *_arena_scope_prev = aoc_arena_use(arena)
+
+/* Allocation hooks of the CTL containers (see ctl.h) */
+
+static inline void *aoc_ctl_malloc(size_t size) {
+    AocArena *arena = aoc_arena_current;
+    return arena ? aoc_arena_alloc(arena, size) : malloc(size);
+}
+
+static inline void *aoc_ctl_calloc(size_t count, size_t size) {
+    AocArena *arena = aoc_arena_current;
+    if (arena == NULL) return calloc(count, size);
+    void *ptr = aoc_arena_alloc(arena, count * size);
+    memset(ptr, 0, count * size);
+    return ptr;
+}
+
+static inline void *aoc_ctl_realloc(void *ptr, size_t old_size, size_t new_size) {
+    AocArena *arena = aoc_arena_current;
+    return arena ? aoc_arena_realloc(arena, ptr, old_size, new_size) : realloc(ptr, new_size);
+}
+
+static inline void aoc_ctl_free(void *ptr) {
+    if (aoc_arena_current == NULL) free(ptr);
+}
+
+#define CTL_MALLOC(size) aoc_ctl_malloc(size)
+#define CTL_CALLOC(count, size) aoc_ctl_calloc(count, size)
+#define CTL_REALLOC(ptr, old_size, new_size) aoc_ctl_realloc(ptr, old_size, new_size)
+#define CTL_FREE(ptr) aoc_ctl_free(ptr)
@@ -0,0 +1,36 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+/**
+ * Instruction set levels the SIMD kernels in lib/aoc are compiled for, named
+ * after the x86-64 microarchitecture levels. Higher levels include the lower
+ * ones.
+ */
+typedef enum {
+    AOC_ISA_BASELINE, /* x86-64 (SSE2), or any other architecture */
+    AOC_ISA_V2,       /* x86-64-v2: SSSE3, SSE4.1, SSE4.2, POPCNT */
+    AOC_ISA_V3,       /* x86-64-v3: AVX2, BMI2, FMA */
+    AOC_ISA_V4,       /* x86-64-v4: AVX-512 F/BW/DQ/VL */
+} AocIsa;
+
+/**
+ * The highest level supported by the CPU (and the OS).
+ *
+ * The environment variable AOC_ISA (one of "x86-64", "x86-64-v2",
+ * "x86-64-v3" or "x86-64-v4") caps the result, which is useful to test or
+ * benchmark the kernels of the lower levels. It is read once, on the first
+ * call.
+ */
+AocIsa aoc_cpu_isa(void);
+
+/**
+ * @return The name of `isa`, e.g. "x86-64-v3".
+ */
+const char *aoc_cpu_isa_name(AocIsa isa);
@@ -0,0 +1,255 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Flat hash set, a cache-friendly replacement for <ust.h>.
+ *
+ * Usage follows the CTL conventions:
+ *
+ *     #define P            // T is plain old data, otherwise T_free() is required
+ *     #define T Entry
+ *     #include "aoc/fmap.h"
+ *
+ *     fmap_Entry map = fmap_Entry_init(Entry_hash, Entry_equal);
+ *
+ * Elements are stored inline in one open-addressing table (SwissTable-style):
+ * every slot has a control byte holding 7 bits of its hash, and a probe
+ * compares the control bytes of 16 slots at once, so a lookup usually touches
+ * a single element. Unlike <ust.h>, find() and insert() return a pointer to
+ * the element itself, which is invalidated by the next insert().
+ *
+ * The table is allocated through the CTL allocation hooks, so it can live in
+ * an arena (see aoc/arena.h).
+ */
+
+#ifndef T
+#error "Template type T undefined for <aoc/fmap.h>"
+#endif
+
+#include <ctl.h>
+
+#ifndef AOC_FMAP_H
+#define AOC_FMAP_H
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define FMAP_GROUP 16
+#define FMAP_EMPTY ((int8_t)-128)
+#define FMAP_DELETED ((int8_t)-2)
+
+/* Bit i is set if ctrl[i] == h2. */
+static inline uint32_t fmap_match(const int8_t *ctrl, int8_t h2) {
+#ifdef __SSE2__
+    __m128i group = _mm_loadu_si128((const __m128i *)ctrl);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(h2)));
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < FMAP_GROUP; i++) mask |= (uint32_t)(ctrl[i] == h2) << i;
+    return mask;
+#endif
+}
+
+/* Bit i is set if slot i is empty or deleted, i.e. its control byte is negative. */
+static inline uint32_t fmap_match_free(const int8_t *ctrl) {
+#ifdef __SSE2__
+    return _mm_movemask_epi8(_mm_loadu_si128((const __m128i *)ctrl));
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < FMAP_GROUP; i++) mask |= (uint32_t)(ctrl[i] < 0) << i;
+    return mask;
+#endif
+}
+
+/* Spreads the bits of a user hash, so that both the slot index and the 7 control bits are usable. */
+static inline size_t fmap_mix(size_t hash) {
+    hash *= 0x9E3779B97F4A7C15ull;
+    return hash ^ (hash >> 32);
+}
+
+/* Tables are filled up to 7/8 of their capacity. */
+static inline size_t fmap_max_size(size_t capacity) { return capacity - capacity / 8; }
+
+#endif
+
+#define A JOIN(fmap, T)
+#define Z JOIN(A, it)
+
+typedef struct A {
+    void (*free)(T *);
+    size_t (*hash)(T *);
+    int (*equal)(T *, T *);
+    T *slots;
+    int8_t *ctrl;       /* capacity + FMAP_GROUP bytes; the first FMAP_GROUP are mirrored at the end */
+    size_t size;        /* number of elements */
+    size_t capacity;    /* 0 or a power of two >= FMAP_GROUP */
+    size_t growth_left; /* empty slots which may be filled before the table must grow */
+} A;
+
+typedef struct Z {
+    void (*step)(struct Z *);
+    T *ref;
+    A *container;
+    size_t index;
+    int done;
+} Z;
+
+static inline A JOIN(A, init)(size_t _hash(T *), int _equal(T *, T *)) {
+    A self = {.hash = _hash, .equal = _equal};
+#ifdef P
+#undef P
+    self.free = NULL;
+#else
+    self.free = JOIN(T, free);
+#endif
+    return self;
+}
+
+static inline int JOIN(A, empty)(A *self) { return self->size == 0; }
+
+static inline void JOIN(A, set_ctrl)(A *self, size_t index, int8_t value) {
+    self->ctrl[index] = value;
+    if (index < FMAP_GROUP) self->ctrl[self->capacity + index] = value;
+}
+
+static inline T *JOIN(A, find_hashed)(A *self, T *key, size_t hash) {
+    size_t mask = self->capacity - 1;
+    int8_t h2 = hash & 0x7f;
+    for (size_t pos = (hash >> 7) & mask, step = FMAP_GROUP;; pos = (pos + step) & mask, step += FMAP_GROUP) {
+        const int8_t *group = self->ctrl + pos;
+        for (uint32_t match = fmap_match(group, h2); match; match &= match - 1) {
+            T *slot = &self->slots[(pos + __builtin_ctz(match)) & mask];
+            if (self->equal(key, slot)) return slot;
+        }
+        if (fmap_match(group, FMAP_EMPTY)) return NULL;
+    }
+}
+
+/* Returns the index of the first empty or deleted slot on the probe sequence of `hash`. */
+static inline size_t JOIN(A, find_free)(A *self, size_t hash) {
+    size_t mask = self->capacity - 1;
+    for (size_t pos = (hash >> 7) & mask, step = FMAP_GROUP;; pos = (pos + step) & mask, step += FMAP_GROUP) {
+        uint32_t match = fmap_match_free(self->ctrl + pos);
+        if (match) return (pos + __builtin_ctz(match)) & mask;
+    }
+}
+
+static inline void JOIN(A, rehash)(A *self, size_t capacity) {
+    A old = *self;
+    self->slots = (T *)CTL_MALLOC(capacity * sizeof(T) + capacity + FMAP_GROUP);
+    self->ctrl = (int8_t *)(self->slots + capacity);
+    self->capacity = capacity;
+    self->growth_left = fmap_max_size(capacity) - old.size;
+    memset(self->ctrl, FMAP_EMPTY, capacity + FMAP_GROUP);
+    for (size_t i = 0; i < old.capacity; i++) {
+        if (old.ctrl[i] < 0) continue;
+        size_t hash = fmap_mix(self->hash(&old.slots[i]));
+        size_t index = JOIN(A, find_free)(self, hash);
+        JOIN(A, set_ctrl)(self, index, hash & 0x7f);
+        self->slots[index] = old.slots[i];
+    }
+    CTL_FREE(old.slots);
+}
+
+static inline void JOIN(A, reserve)(A *self, size_t desired_count) {
+    size_t capacity = FMAP_GROUP;
+    while (fmap_max_size(capacity) < desired_count) capacity *= 2;
+    if (capacity > self->capacity) JOIN(A, rehash)(self, capacity);
+}
+
+static inline T *JOIN(A, find)(A *self, T key) {
+    if (JOIN(A, empty)(self)) return NULL;
+    return JOIN(A, find_hashed)(self, &key, fmap_mix(self->hash(&key)));
+}
+
+static inline size_t JOIN(A, count)(A *self, T key) { return JOIN(A, find)(self, key) ? 1 : 0; }
+
+/**
+ * Inserts `value` unless an equal element exists already (in which case
+ * `value` is freed, like ust_insert()).
+ *
+ * @return The element in the table.
+ */
+static inline T *JOIN(A, insert)(A *self, T value) {
+    size_t hash = fmap_mix(self->hash(&value));
+    if (!JOIN(A, empty)(self)) {
+        T *found = JOIN(A, find_hashed)(self, &value, hash);
+        if (found) {
+            if (self->free) self->free(&value);
+            return found;
+        }
+    }
+    if (self->growth_left == 0) {
+        // only grow if the table is mostly full of elements rather than tombstones
+        size_t capacity = self->capacity == 0 ? FMAP_GROUP : self->capacity;
+        JOIN(A, rehash)(self, 2 * self->size >= fmap_max_size(capacity) ? 2 * capacity : capacity);
+    }
+    size_t index = JOIN(A, find_free)(self, hash);
+    if (self->ctrl[index] == FMAP_EMPTY) self->growth_left--;
+    JOIN(A, set_ctrl)(self, index, hash & 0x7f);
+    self->slots[index] = value;
+    self->size++;
+    return &self->slots[index];
+}
+
+static inline int JOIN(A, erase)(A *self, T key) {
+    T *found = JOIN(A, find)(self, key);
+    if (found == NULL) return 0;
+    if (self->free) self->free(found);
+    JOIN(A, set_ctrl)(self, found - self->slots, FMAP_DELETED);
+    self->size--;
+    return 1;
+}
+
+static inline void JOIN(A, clear)(A *self) {
+    if (self->capacity == 0) return;
+    if (self->free) {
+        for (size_t i = 0; i < self->capacity; i++) {
+            if (self->ctrl[i] >= 0) self->free(&self->slots[i]);
+        }
+    }
+    memset(self->ctrl, FMAP_EMPTY, self->capacity + FMAP_GROUP);
+    self->size = 0;
+    self->growth_left = fmap_max_size(self->capacity);
+}
+
+static inline void JOIN(A, free)(A *self) {
+    JOIN(A, clear)(self);
+    CTL_FREE(self->slots);
+    self->slots = NULL;
+    self->ctrl = NULL;
+    self->capacity = self->growth_left = 0;
+}
+
+static inline void JOIN(Z, scan)(Z *self, size_t from) {
+    A *container = self->container;
+    for (size_t i = from; i < container->capacity; i++) {
+        if (container->ctrl[i] >= 0) {
+            self->index = i;
+            self->ref = &container->slots[i];
+            return;
+        }
+    }
+    self->done = 1;
+}
+
+static inline void JOIN(Z, step)(Z *self) { JOIN(Z, scan)(self, self->index + 1); }
+
+static inline Z JOIN(Z, each)(A *container) {
+    Z self = {.step = JOIN(Z, step), .container = container};
+    JOIN(Z, scan)(&self, 0);
+    return self;
+}
+
+#undef T
+#undef A
+#undef Z
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <stdbool.h>
 #include <stddef.h>
 
 /**
@@ -28,3 +29,122 @@
  * error.
  */
 int aoc_io_read_input(const char *fname, char *buf, size_t buf_size);
+
+/**
+ * A memory-mapped input file, see aoc_io_map_input().
+ */
+typedef struct {
+    char *buf;          /* file contents, followed by a '\0' sentinel */
+    size_t size;        /* file size in bytes (without the sentinel) */
+    size_t mapped_size; /* length of the mapping backing `buf` */
+} AocInput;
+
+/**
+ * Maps a file read-only into memory.
+ *
+ * The file is mapped without copying it and without any limit on its size.
+ * The mapping is always followed by at least one '\0' byte, so `input->buf`
+ * can be used as a null-terminated string. Files which cannot be mapped
+ * (e.g. pipes) are read into an anonymous mapping instead.
+ *
+ * Solvers must not write to `input->buf`.
+ *
+ * @param fname Pointer to a null-terminated string that specifies the name of
+ * the file to be mapped.
+ * @param input Receives the mapping. It is reset first, so it can always be
+ * passed to aoc_io_unmap_input(), even if this function fails.
+ *
+ * @return 0 on success, a negative value on error.
+ */
+int aoc_io_map_input(const char *fname, AocInput *input);
+
+/**
+ * Releases a mapping obtained from aoc_io_map_input(). Suitable for use with
+ * _cleanup_().
+ */
+void aoc_io_unmap_input(AocInput *input);
+
+/**
+ * A growable, reusable buffer for aoc_io_read_into().
+ */
+typedef struct {
+    char *buf;
+    size_t size;     /* number of bytes read */
+    size_t capacity; /* bytes allocated for buf */
+} AocBuffer;
+
+/**
+ * Reads the whole file `fname` into `buffer`, growing it as needed, and
+ * null-terminates it. Reusing the same buffer for many (small) files avoids
+ * an allocation or mapping per file.
+ *
+ * @return 0 on success, a negative value on error.
+ */
+int aoc_io_read_into(const char *fname, AocBuffer *buffer);
+
+/**
+ * Sets the size of `buffer` to `size` bytes, growing it as needed, and
+ * null-terminates it. The previous contents are not preserved; the caller
+ * fills the buffer itself, e.g. piecewise from a non-blocking socket.
+ *
+ * @return 0 on success, a negative value if out of memory.
+ */
+int aoc_io_buffer_resize(AocBuffer *buffer, size_t size);
+
+/**
+ * Releases the memory of `buffer`. Suitable for use with _cleanup_().
+ */
+void aoc_io_buffer_free(AocBuffer *buffer);
+
+/**
+ * A streaming reader which yields an input file in newline-aligned chunks.
+ *
+ * A background thread reads the next chunk while the caller processes the
+ * current one (double buffering), so I/O and compute overlap and memory usage
+ * is bounded by two chunks regardless of the size of the input.
+ */
+typedef struct AocStream AocStream;
+
+/* A sensible default chunk size for aoc_stream_open(). */
+#define AOC_STREAM_CHUNK_SIZE (1 << 20)
+
+/**
+ * Opens `fname` for streaming, see aoc_stream_fdopen().
+ *
+ * @return The stream or NULL on error.
+ */
+AocStream *aoc_stream_open(const char *fname, size_t chunk_size);
+
+/**
+ * Starts streaming from the file descriptor `fd`, which may refer to a pipe.
+ * The stream takes ownership of `fd`.
+ *
+ * @param chunk_size The preferred chunk size in bytes. Chunks are grown as
+ * needed if a single line is longer than this.
+ *
+ * @return The stream or NULL on error.
+ */
+AocStream *aoc_stream_fdopen(int fd, size_t chunk_size);
+
+/**
+ * Returns the next chunk of the input.
+ *
+ * A chunk consists of complete lines only: it always ends with '\n' (one is
+ * appended to the last line of the input if it is missing) and is followed by
+ * a '\0' sentinel. The chunk stays valid until the next call.
+ *
+ * @return true if a chunk was returned, false at the end of the input or on a
+ * read error (see aoc_stream_error()).
+ */
+bool aoc_stream_next(AocStream *stream, char **chunk, size_t *chunk_size);
+
+/**
+ * @return true if reading the input failed.
+ */
+bool aoc_stream_error(AocStream *stream);
+
+/**
+ * Stops the reader thread and releases the stream. Suitable for use with
+ * _cleanup_().
+ */
+void aoc_stream_close(AocStream **stream);
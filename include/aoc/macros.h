@@ -60,3 +60,26 @@
  *   INDEX(myArray, 2, 1, W) = 42; // Sets the element at (x=2, y=1) to 42
  */
 #define INDEX(arr, x, y, W) ((arr)[(y) * (W) + (x)])
+
+/**
+ * Adds the time spent from this point until the end of the enclosing scope to
+ * the given phase ('parse', 'part1' or 'part2') of `result->timing`.
+ *
+ * Unless AOC_TIMING is defined (meson option 'timing') the macro only marks
+ * `result` as used, so instrumented solvers cost nothing in regular builds.
+ *
+ * Example usage:
+ *   { // parser
+ *       TIME_PHASE(result, parse);
+ *       ...
+ *   }
+ */
+#ifdef AOC_TIMING
+#define TIME_PHASE(result, phase)                                                                                      \
+    _cleanup_(aoc_time_phase_end) AocTimePhase _time_phase_##phase = {                                                 \
+        .acc = &(result)->timing.phase##_ns,                                                                           \
+        .start = aoc_time_now_ns(),                                                                                    \
+    }
+#else
+#define TIME_PHASE(result, phase) ((void)(result))
+#endif
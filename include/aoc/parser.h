@@ -11,6 +11,20 @@
 #include "aoc/types.h"
 #include <stdbool.h>
 #include <stddef.h>
+#include <string.h>
+
+/*
+ * The scans below are inline: most runs in the inputs are a few bytes long,
+ * and for those a call costs more than the scan. Runs longer than
+ * AOC_PARSE_SHORT_SCAN bytes are finished by the vector kernels of the
+ * aoc_parse_*_long() functions.
+ */
+#define AOC_PARSE_SHORT_SCAN 16
+
+size_t aoc_parse_skip_ws_long(const char *buf, size_t pos);
+size_t aoc_parse_seek_long(const char *buf, size_t pos, char needle);
+size_t aoc_parse_seek_any_long(const char *buf, size_t pos, const char *needles);
+size_t aoc_parse_seek_digit_long(const char *buf, size_t pos, char stop);
 
 /**
  * Parses a non-negative integer from a given string.
@@ -60,6 +74,24 @@ i64 aoc_parse_nonnegative(const char *buf, size_t *pos);
  */
 bool aoc_parse_integer(const char *buf, size_t *pos, i64 *out);
 
+/**
+ * Parses consecutive whitespace-separated integers, e.g. all numbers of a line.
+ *
+ * Parsing stops at the first token which is not an integer (such as a newline
+ * or a '|') or once `capacity` integers have been parsed. Integers may have a
+ * sign, like in aoc_parse_integer().
+ *
+ * @param buf The buffer to parse.
+ * @param pos Pointer to the position where parsing starts. It is updated to
+ * the position of the token which stopped parsing, or to the position after
+ * the last integer if `capacity` integers were parsed.
+ * @param out Receives the parsed integers.
+ * @param capacity The maximum number of integers to parse.
+ *
+ * @return The number of parsed integers.
+ */
+size_t aoc_parse_integers(const char *buf, size_t *pos, i64 *out, size_t capacity);
+
 /**
  * Skips over any whitespace characters in the buffer starting from the position
  * pointed by pos.
@@ -73,7 +105,16 @@ bool aoc_parse_integer(const char *buf, size_t *pos, i64 *out);
  * last whitespace character encountered. If there are no whitespace characters,
  * *pos remains unchanged.
  */
-void aoc_parse_skip_ws(const char *buf, size_t *pos);
+static inline void aoc_parse_skip_ws(const char *buf, size_t *pos) {
+    size_t i = *pos, end = i + AOC_PARSE_SHORT_SCAN;
+    while (buf[i] == ' ') {
+        if (++i == end) {
+            i = aoc_parse_skip_ws_long(buf, i);
+            break;
+        }
+    }
+    *pos = i;
+}
 
 /**
  * Searches for the first occurrence of the specified character (needle) in the
@@ -87,4 +128,66 @@ void aoc_parse_skip_ws(const char *buf, size_t *pos);
  * @note The function updates *pos to the position of the first occurrence of
  * needle. If the needle is not found, *pos is set to the length of the buffer.
  */
-void aoc_parse_seek(const char *buf, size_t *pos, char needle);
+static inline void aoc_parse_seek(const char *buf, size_t *pos, char needle) {
+    size_t i = *pos, end = i + AOC_PARSE_SHORT_SCAN;
+    while (buf[i] != needle && buf[i] != '\0') {
+        if (++i == end) {
+            i = aoc_parse_seek_long(buf, i, needle);
+            break;
+        }
+    }
+    *pos = i;
+}
+
+/**
+ * Like aoc_parse_seek(), but stops at the first occurrence of any of the
+ * characters in `needles`.
+ *
+ * @param buf The buffer in which to search.
+ * @param pos Pointer to the size_t variable that holds the starting position
+ * for the search and is updated to the position of the found character.
+ * @param needles A null-terminated string of at most 8 characters to search
+ * for, e.g. ":|\n".
+ *
+ * @note If none of the needles is found, *pos is set to the length of the
+ * buffer.
+ */
+static inline void aoc_parse_seek_any(const char *buf, size_t *pos, const char *needles) {
+    size_t i = *pos, end = i + AOC_PARSE_SHORT_SCAN;
+    while (buf[i] != '\0' && strchr(needles, buf[i]) == NULL) {
+        if (++i == end) {
+            i = aoc_parse_seek_any_long(buf, i, needles);
+            break;
+        }
+    }
+    *pos = i;
+}
+
+/**
+ * Like aoc_parse_seek(), but stops at the first digit or `stop`, whichever
+ * comes first.
+ *
+ * @param buf The buffer in which to search.
+ * @param pos Pointer to the size_t variable that holds the starting position
+ * for the search and is updated to the position of the found character.
+ * @param stop The character which ends the search, e.g. '\n'.
+ *
+ * @note If neither is found, *pos is set to the length of the buffer.
+ */
+static inline void aoc_parse_seek_digit(const char *buf, size_t *pos, char stop) {
+    size_t i = *pos, end = i + AOC_PARSE_SHORT_SCAN;
+    while (!(buf[i] >= '0' && buf[i] <= '9') && buf[i] != stop && buf[i] != '\0') {
+        if (++i == end) {
+            i = aoc_parse_seek_digit_long(buf, i, stop);
+            break;
+        }
+    }
+    *pos = i;
+}
+
+/**
+ * Searches buf[begin, end) backwards for a digit.
+ *
+ * @return The position of the last digit, or `end` if there is none.
+ */
+size_t aoc_parse_rfind_digit(const char *buf, size_t begin, size_t end);
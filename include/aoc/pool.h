@@ -0,0 +1,72 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * A fixed-size thread pool with work stealing.
+ *
+ * Every worker owns a task deque: it takes its own tasks from the back and,
+ * once that is empty, steals from the front of the other workers' deques.
+ * Tasks are expected to be coarse-grained (e.g. solving a whole input).
+ */
+typedef struct AocPool AocPool;
+
+/**
+ * A task. `worker` is the index (0 <= worker < aoc_pool_size()) of the worker
+ * running it, which can be used to index per-worker scratch space.
+ */
+typedef void (*AocTaskFn)(void *arg, int worker);
+
+/* Stack size of the worker threads; solvers keep their grids on the stack. */
+#define AOC_POOL_STACK_SIZE (16 << 20)
+
+/**
+ * Starts a pool with `threads` workers, or one per online CPU if `threads` is
+ * not positive.
+ *
+ * @return The pool or NULL on error.
+ */
+AocPool *aoc_pool_create(int threads);
+
+/**
+ * @return The number of workers of `pool`.
+ */
+int aoc_pool_size(const AocPool *pool);
+
+/**
+ * Queues `fn(arg)`; tasks are distributed round-robin over the workers.
+ */
+void aoc_pool_submit(AocPool *pool, AocTaskFn fn, void *arg);
+
+/**
+ * Queues `fn(arg)` on the deque of a specific worker (it may still be stolen
+ * by another worker).
+ */
+void aoc_pool_submit_to(AocPool *pool, int worker, AocTaskFn fn, void *arg);
+
+/**
+ * Blocks until all submitted tasks have finished.
+ */
+void aoc_pool_wait(AocPool *pool);
+
+/**
+ * @return true if the calling thread is a worker of any pool. Code which could
+ * start a pool of its own should run sequentially then, since its caller
+ * already keeps the cores busy.
+ */
+bool aoc_pool_in_worker(void);
+
+/**
+ * Waits for all submitted tasks, stops the workers and releases the pool.
+ * Suitable for use with _cleanup_().
+ */
+void aoc_pool_destroy(AocPool **pool);
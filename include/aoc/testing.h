@@ -0,0 +1,37 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include "aoc/io.h"
+#include "solve.h"
+
+/* Chunk size of aoc_test_solve_stream(): small, so that lines cross chunk boundaries. */
+#define AOC_TEST_CHUNK_SIZE 16
+
+/**
+ * Solves `buf` with solve_stream(), reading it from a temporary file in
+ * chunks of AOC_TEST_CHUNK_SIZE bytes.
+ *
+ * @return The result of solve_stream(), or -1 if the stream could not be set up.
+ */
+static inline int aoc_test_solve_stream(const char *buf, Solution *solution) {
+    FILE *f = tmpfile();
+    if (f == NULL) return -1;
+    fputs(buf, f);
+    rewind(f);
+    AocStream *stream = aoc_stream_fdopen(dup(fileno(f)), AOC_TEST_CHUNK_SIZE);
+    fclose(f);
+    if (stream == NULL) return -1;
+    int rc = solve_stream(stream, solution);
+    aoc_stream_close(&stream);
+    return rc;
+}
@@ -0,0 +1,33 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <time.h>
+
+#include "aoc/macros.h"
+#include "aoc/types.h"
+
+/**
+ * Returns a monotonic timestamp in nanoseconds.
+ *
+ * Only the difference between two timestamps is meaningful.
+ */
+static _unused_ inline u64 aoc_time_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000ull + (u64)ts.tv_nsec;
+}
+
+typedef struct {
+    u64 *acc;
+    u64 start;
+} AocTimePhase;
+
+/* Scope-exit handler of TIME_PHASE(). */
+static _unused_ inline void aoc_time_phase_end(AocTimePhase *phase) { *phase->acc += aoc_time_now_ns() - phase->start; }
@@ -9,11 +9,35 @@
 #pragma once
 
 #include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Durations (in nanoseconds) of the phases of a solve() call, recorded by
+ * TIME_PHASE() in builds with -Dtiming=true. Phases which a day does not
+ * instrument stay zero; the caller has to zero the struct before solve().
+ */
+typedef struct SolveTiming {
+    uint64_t parse_ns;
+    uint64_t part1_ns;
+    uint64_t part2_ns;
+} SolveTiming;
 
 typedef struct Solution {
     char part1[64];
     char part2[64];
+#ifdef AOC_TIMING
+    SolveTiming timing;
+#endif
 } Solution;
 
+typedef struct AocStream AocStream;
+
 void solve(char *buf, size_t buf_size, Solution *result);
 int solve_input(const char *fname, Solution *result);
+
+/*
+ * Streaming variant of solve(), only implemented by line-oriented days. The
+ * input is consumed chunk by chunk (see aoc_stream_next()), so it never has
+ * to be in memory as a whole. Returns a negative value on read errors.
+ */
+int solve_stream(AocStream *stream, Solution *result);
@@ -0,0 +1,112 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "aoc/arena.h"
+
+#define ALIGNMENT 16
+
+typedef struct Block {
+    struct Block *next;
+    size_t capacity;
+    _Alignas(ALIGNMENT) char data[];
+} Block;
+
+struct AocArena {
+    Block *first;   /* all blocks, in order of use */
+    Block *current; /* the block we are allocating from */
+    size_t used;    /* bytes used in `current` */
+    size_t block_size;
+    void *last; /* the most recent allocation */
+};
+
+_Thread_local AocArena *aoc_arena_current;
+
+static size_t align_up(size_t n) { return (n + ALIGNMENT - 1) & ~(size_t)(ALIGNMENT - 1); }
+
+static Block *block_new(size_t capacity) {
+    Block *block = malloc(sizeof(Block) + capacity);
+    if (block == NULL) {
+        fprintf(stderr, "arena: out of memory\n");
+        abort();
+    }
+    block->next = NULL;
+    block->capacity = capacity;
+    return block;
+}
+
+AocArena *aoc_arena_create(size_t block_size) {
+    AocArena *arena = calloc(1, sizeof(*arena));
+    if (arena == NULL) return NULL;
+    arena->block_size = align_up(block_size ? block_size : AOC_ARENA_BLOCK_SIZE);
+    return arena;
+}
+
+void aoc_arena_destroy(AocArena **arena) {
+    AocArena *a = *arena;
+    if (a == NULL) return;
+    Block *block = a->first;
+    while (block != NULL) {
+        Block *next = block->next;
+        free(block);
+        block = next;
+    }
+    free(a);
+    *arena = NULL;
+}
+
+/* Moves on to the next block which can hold `size` bytes, reusing blocks of an earlier reset. */
+static void next_block(AocArena *arena, size_t size) {
+    Block *next = arena->current ? arena->current->next : arena->first;
+    if (next == NULL || next->capacity < size) {
+        Block *block = block_new(MAX(size, arena->block_size));
+        block->next = next;
+        if (arena->current) {
+            arena->current->next = block;
+        } else {
+            arena->first = block;
+        }
+        next = block;
+    }
+    arena->current = next;
+    arena->used = 0;
+}
+
+void *aoc_arena_alloc(AocArena *arena, size_t size) {
+    size = align_up(size ? size : 1);
+    if (arena->current == NULL || arena->current->capacity - arena->used < size) next_block(arena, size);
+    void *ptr = arena->current->data + arena->used;
+    arena->used += size;
+    arena->last = ptr;
+    return ptr;
+}
+
+void *aoc_arena_realloc(AocArena *arena, void *ptr, size_t old_size, size_t new_size) {
+    if (ptr == NULL) return aoc_arena_alloc(arena, new_size);
+    if (ptr == arena->last) {
+        size_t offset = (char *)ptr - arena->current->data;
+        size_t size = align_up(new_size ? new_size : 1);
+        if (arena->current->capacity - offset >= size) {
+            arena->used = offset + size;
+            return ptr;
+        }
+    }
+    if (new_size <= old_size) return ptr;
+    void *result = aoc_arena_alloc(arena, new_size);
+    memcpy(result, ptr, old_size);
+    return result;
+}
+
+void aoc_arena_reset(AocArena *arena) {
+    arena->current = arena->first;
+    arena->used = 0;
+    arena->last = NULL;
+}
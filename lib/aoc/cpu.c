@@ -0,0 +1,50 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "aoc/cpu.h"
+
+static const char *const names[] = {"x86-64", "x86-64-v2", "x86-64-v3", "x86-64-v4"};
+
+static AocIsa detect(void) {
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    if (!(__builtin_cpu_supports("ssse3") && __builtin_cpu_supports("sse4.1") && __builtin_cpu_supports("sse4.2") &&
+          __builtin_cpu_supports("popcnt")))
+        return AOC_ISA_BASELINE;
+    if (!(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi2") && __builtin_cpu_supports("fma")))
+        return AOC_ISA_V2;
+    if (!(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+          __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl")))
+        return AOC_ISA_V3;
+    return AOC_ISA_V4;
+#else
+    return AOC_ISA_BASELINE;
+#endif
+}
+
+AocIsa aoc_cpu_isa(void) {
+    // racing threads compute the same value
+    static int cached = -1;
+    int isa = __atomic_load_n(&cached, __ATOMIC_RELAXED);
+    if (isa >= 0) return isa;
+
+    isa = detect();
+    const char *cap = getenv("AOC_ISA");
+    if (cap != NULL) {
+        for (int i = 0; i < (int)(sizeof(names) / sizeof(names[0])); i++) {
+            if (strcmp(cap, names[i]) == 0 && i < isa) isa = i;
+        }
+    }
+    __atomic_store_n(&cached, isa, __ATOMIC_RELAXED);
+    return isa;
+}
+
+const char *aoc_cpu_isa_name(AocIsa isa) { return names[isa]; }
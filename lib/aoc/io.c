@@ -6,7 +6,15 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "aoc/io.h"
 #include "aoc/macros.h"
@@ -17,6 +25,101 @@ static inline void my_fclose(FILE **fp) {
     if (f) fclose(f);
 }
 
+static inline void my_close(int *fdp) {
+    int fd = *fdp;
+    if (fd >= 0) close(fd);
+}
+
+static size_t page_align(size_t n) {
+    size_t page_size = sysconf(_SC_PAGESIZE);
+    return (n + page_size - 1) & ~(page_size - 1);
+}
+
+static char *map_anonymous(size_t size) {
+    char *buf = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return buf == MAP_FAILED ? NULL : buf;
+}
+
+/* Fallback for files without a size, e.g. pipes: read everything into an anonymous mapping. */
+static int read_unmappable(int fd, AocInput *input) {
+    size_t capacity = page_align(1 << 16), size = 0;
+    char *buf = map_anonymous(capacity);
+    if (buf == NULL) {
+        perror("Error mapping input");
+        return -2;
+    }
+    while (1) {
+        if (size + 1 == capacity) { // always keep room for the sentinel
+            char *larger = map_anonymous(2 * capacity);
+            if (larger == NULL) {
+                perror("Error mapping input");
+                munmap(buf, capacity);
+                return -2;
+            }
+            memcpy(larger, buf, size);
+            munmap(buf, capacity);
+            buf = larger;
+            capacity *= 2;
+        }
+        ssize_t n = read(fd, buf + size, capacity - size - 1);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) {
+            perror("Error reading file");
+            munmap(buf, capacity);
+            return -3;
+        }
+        if (n == 0) break;
+        size += n;
+    }
+    /* anonymous mappings are zero-filled, hence buf[size] == '\0' */
+    mprotect(buf, capacity, PROT_READ);
+    *input = (AocInput){.buf = buf, .size = size, .mapped_size = capacity};
+    return 0;
+}
+
+int aoc_io_map_input(const char *fname, AocInput *input) {
+    *input = (AocInput){0};
+
+    _cleanup_(my_close) int fd = open(fname, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        perror("Error opening input:");
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        perror("Error opening input:");
+        return -1;
+    }
+    if (!S_ISREG(st.st_mode)) return read_unmappable(fd, input);
+
+    /*
+     * Reserve the pages of the file plus one guard page, then map the file
+     * over the front of the reservation. The kernel zero-fills the tail of the
+     * last file page and the guard page is all zeros, so there is a '\0' right
+     * after the last byte of the file, even if its size is a multiple of the
+     * page size.
+     */
+    size_t size = st.st_size;
+    size_t mapped_size = page_align(size) + page_align(1);
+    char *buf = mmap(NULL, mapped_size, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buf == MAP_FAILED) {
+        perror("Error mapping input");
+        return -2;
+    }
+    if (size > 0 && mmap(buf, size, PROT_READ, MAP_PRIVATE | MAP_FIXED | MAP_POPULATE, fd, 0) == MAP_FAILED) {
+        perror("Error mapping input");
+        munmap(buf, mapped_size);
+        return -2;
+    }
+    *input = (AocInput){.buf = buf, .size = size, .mapped_size = mapped_size};
+    return 0;
+}
+
+void aoc_io_unmap_input(AocInput *input) {
+    if (input->buf != NULL) munmap(input->buf, input->mapped_size);
+    *input = (AocInput){0};
+}
+
 int aoc_io_read_input(const char *fname, char *buf, size_t buf_size) {
     _cleanup_(my_fclose) FILE *f = fopen(fname, "r");
     if (!f) {
@@ -41,3 +144,253 @@ int aoc_io_read_input(const char *fname, char *buf, size_t buf_size) {
     buf[end] = '\0';
     return end;
 }
+
+static bool buffer_reserve(AocBuffer *buffer, size_t capacity) {
+    if (capacity <= buffer->capacity) return true;
+    char *buf = realloc(buffer->buf, capacity);
+    if (buf == NULL) return false;
+    buffer->buf = buf;
+    buffer->capacity = capacity;
+    return true;
+}
+
+int aoc_io_read_into(const char *fname, AocBuffer *buffer) {
+    buffer->size = 0;
+    _cleanup_(my_close) int fd = open(fname, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        perror("Error opening input:");
+        return -1;
+    }
+    struct stat st;
+    size_t hint = fstat(fd, &st) == 0 && S_ISREG(st.st_mode) ? (size_t)st.st_size : 0;
+    if (!buffer_reserve(buffer, MAX(hint + 2, (size_t)4096))) return -2;
+
+    size_t size = 0;
+    while (1) {
+        // + 1 for the sentinel; files may grow after fstat() or have no size
+        if (size + 1 == buffer->capacity && !buffer_reserve(buffer, 2 * buffer->capacity)) return -2;
+        ssize_t n = read(fd, buffer->buf + size, buffer->capacity - size - 1);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) {
+            perror("Error reading file");
+            return -3;
+        }
+        if (n == 0) break;
+        size += n;
+    }
+    buffer->buf[size] = '\0';
+    buffer->size = size;
+    return 0;
+}
+
+int aoc_io_buffer_resize(AocBuffer *buffer, size_t size) {
+    if (!buffer_reserve(buffer, MAX(size + 1, (size_t)4096))) return -2;
+    buffer->buf[size] = '\0';
+    buffer->size = size;
+    return 0;
+}
+
+void aoc_io_buffer_free(AocBuffer *buffer) {
+    free(buffer->buf);
+    *buffer = (AocBuffer){0};
+}
+
+/* Streaming */
+
+#define STREAM_SLOTS 2
+
+typedef struct {
+    char *buf;
+    size_t capacity; /* bytes allocated for buf */
+    size_t len;      /* length of the chunk in buf */
+    bool filled;     /* owned by the consumer if true, by the reader otherwise */
+    bool last;       /* no chunks follow this one */
+} StreamSlot;
+
+struct AocStream {
+    int fd;
+    pthread_t reader;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    StreamSlot slot[STREAM_SLOTS];
+    int current; /* slot handed out by aoc_stream_next(), -1 before the first call */
+    bool closing, error;
+
+    /* reader state: capacity of new slots and the incomplete line of the previous read */
+    size_t capacity;
+    char *carry;
+    size_t carry_len;
+};
+
+static bool stream_grow(AocStream *s, StreamSlot *slot, size_t capacity) {
+    if (capacity > s->capacity) {
+        char *carry = realloc(s->carry, capacity);
+        if (carry == NULL) return false;
+        s->carry = carry;
+        s->capacity = capacity;
+    }
+    if (capacity > slot->capacity) {
+        char *buf = realloc(slot->buf, capacity);
+        if (buf == NULL) return false;
+        slot->buf = buf;
+        slot->capacity = capacity;
+    }
+    return true;
+}
+
+/* Fills `slot` with the carry of the previous chunk followed by as many complete lines as fit. */
+static bool stream_fill(AocStream *s, StreamSlot *slot) {
+    if (!stream_grow(s, slot, s->capacity)) return false;
+    memcpy(slot->buf, s->carry, s->carry_len);
+    size_t len = s->carry_len;
+    s->carry_len = 0;
+
+    while (1) {
+        // keep room for a trailing newline and the sentinel
+        bool eof = false;
+        while (len + 2 < slot->capacity) {
+            ssize_t n = read(s->fd, slot->buf + len, slot->capacity - 2 - len);
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0) return false;
+            if (n == 0) {
+                eof = true;
+                break;
+            }
+            len += n;
+        }
+
+        if (eof) {
+            if (len > 0 && slot->buf[len - 1] != '\n') slot->buf[len++] = '\n';
+            slot->last = true;
+            break;
+        }
+        char *newline = memrchr(slot->buf, '\n', len);
+        if (newline != NULL) {
+            size_t end = newline - slot->buf + 1;
+            s->carry_len = len - end;
+            memcpy(s->carry, slot->buf + end, s->carry_len);
+            len = end;
+            break;
+        }
+        // a single line does not fit into the slot
+        if (!stream_grow(s, slot, 2 * slot->capacity)) return false;
+    }
+
+    slot->buf[len] = '\0';
+    slot->len = len;
+    return true;
+}
+
+static void *stream_reader(void *arg) {
+    AocStream *s = arg;
+    bool last = false;
+    for (int i = 0; !last; i = (i + 1) % STREAM_SLOTS) {
+        StreamSlot *slot = &s->slot[i];
+
+        pthread_mutex_lock(&s->mutex);
+        while (slot->filled && !s->closing) pthread_cond_wait(&s->cond, &s->mutex);
+        bool closing = s->closing;
+        pthread_mutex_unlock(&s->mutex);
+        if (closing) break;
+
+        bool ok = stream_fill(s, slot);
+
+        pthread_mutex_lock(&s->mutex);
+        if (!ok) {
+            s->error = true;
+            slot->len = 0;
+            slot->last = true;
+        }
+        last = slot->last;
+        slot->filled = true;
+        pthread_cond_broadcast(&s->cond);
+        pthread_mutex_unlock(&s->mutex);
+    }
+    return NULL;
+}
+
+static void stream_free(AocStream *s) {
+    for (int i = 0; i < STREAM_SLOTS; i++) free(s->slot[i].buf);
+    free(s->carry);
+    close(s->fd);
+    pthread_cond_destroy(&s->cond);
+    pthread_mutex_destroy(&s->mutex);
+    free(s);
+}
+
+AocStream *aoc_stream_open(const char *fname, size_t chunk_size) {
+    int fd = open(fname, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        perror("Error opening input:");
+        return NULL;
+    }
+    return aoc_stream_fdopen(fd, chunk_size);
+}
+
+AocStream *aoc_stream_fdopen(int fd, size_t chunk_size) {
+    AocStream *s = calloc(1, sizeof(*s));
+    if (s == NULL) {
+        close(fd);
+        return NULL;
+    }
+    s->fd = fd;
+    s->current = -1;
+    pthread_mutex_init(&s->mutex, NULL);
+    pthread_cond_init(&s->cond, NULL);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL); // fails harmlessly for pipes
+
+    size_t capacity = MAX(chunk_size, (size_t)1) + 2; // newline and sentinel
+    for (int i = 0; i < STREAM_SLOTS; i++) {
+        if (!stream_grow(s, &s->slot[i], capacity)) {
+            stream_free(s);
+            return NULL;
+        }
+    }
+    if (pthread_create(&s->reader, NULL, stream_reader, s) != 0) {
+        perror("Error starting reader thread");
+        stream_free(s);
+        return NULL;
+    }
+    return s;
+}
+
+bool aoc_stream_next(AocStream *s, char **chunk, size_t *chunk_size) {
+    pthread_mutex_lock(&s->mutex);
+    if (s->current >= 0) {
+        StreamSlot *prev = &s->slot[s->current];
+        if (prev->last) {
+            pthread_mutex_unlock(&s->mutex);
+            return false;
+        }
+        prev->filled = false; // hand it back to the reader
+        pthread_cond_broadcast(&s->cond);
+    }
+    s->current = (s->current + 1) % STREAM_SLOTS;
+    StreamSlot *slot = &s->slot[s->current];
+    while (!slot->filled) pthread_cond_wait(&s->cond, &s->mutex);
+    pthread_mutex_unlock(&s->mutex);
+
+    if (slot->len == 0) return false;
+    *chunk = slot->buf;
+    *chunk_size = slot->len;
+    return true;
+}
+
+bool aoc_stream_error(AocStream *s) {
+    pthread_mutex_lock(&s->mutex);
+    bool error = s->error;
+    pthread_mutex_unlock(&s->mutex);
+    return error;
+}
+
+void aoc_stream_close(AocStream **stream) {
+    AocStream *s = *stream;
+    if (s == NULL) return;
+    pthread_mutex_lock(&s->mutex);
+    s->closing = true;
+    pthread_cond_broadcast(&s->cond);
+    pthread_mutex_unlock(&s->mutex);
+    pthread_join(s->reader, NULL);
+    stream_free(s);
+    *stream = NULL;
+}
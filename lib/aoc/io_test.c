@@ -0,0 +1,59 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define CTEST_MAIN
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "aoc/io.h"
+#include "ctest.h"
+
+/* Streams `buf` in chunks of `chunk_size` bytes and concatenates the chunks into `out`. */
+static size_t stream_all(const char *buf, size_t chunk_size, char *out, size_t out_size) {
+    FILE *f = tmpfile();
+    fputs(buf, f);
+    rewind(f);
+    AocStream *stream = aoc_stream_fdopen(dup(fileno(f)), chunk_size);
+    fclose(f);
+    ASSERT_NOT_NULL(stream);
+    size_t size = 0;
+    char *chunk;
+    size_t len;
+    while (aoc_stream_next(stream, &chunk, &len)) {
+        // every chunk consists of complete lines and is followed by a sentinel
+        ASSERT_TRUE(len > 0);
+        ASSERT_EQUAL('\n', chunk[len - 1]);
+        ASSERT_EQUAL('\0', chunk[len]);
+        ASSERT_TRUE(size + len < out_size);
+        memcpy(&out[size], chunk, len);
+        size += len;
+    }
+    ASSERT_FALSE(aoc_stream_error(stream));
+    aoc_stream_close(&stream);
+    out[size] = '\0';
+    return size;
+}
+
+CTEST(io, stream_long_line) {
+    const char *buf = "a line much longer than the chunk size\nshort\nanother line longer than 8 bytes\n";
+    char out[256];
+    size_t size = stream_all(buf, 8, out, sizeof(out));
+    ASSERT_EQUAL(strlen(buf), size);
+    ASSERT_STR(buf, out);
+}
+
+CTEST(io, stream_no_final_newline) {
+    char out[256];
+    size_t size = stream_all("first\nsecond\nlast line without newline", 8, out, sizeof(out));
+    ASSERT_EQUAL(strlen("first\nsecond\nlast line without newline\n"), size);
+    ASSERT_STR("first\nsecond\nlast line without newline\n", out);
+}
+
+int main(int argc, const char *argv[]) { return ctest_main(argc, argv); }
@@ -10,23 +10,207 @@
 #include <errno.h>
 #include <limits.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include "aoc/cpu.h"
 #include "aoc/parser.h"
 
-void aoc_parse_skip_ws(const char *buf, size_t *pos) {
-    int i = *pos;
-    while (buf[i] == ' ') i++;
-    *pos = i;
-    assert(buf[*pos] != ' ');
+/*
+ * The SIMD kernels are compiled for several instruction set levels and selected at runtime (see aoc/cpu.h), so
+ * they do not depend on -march. Their vector loads may read past the end of a buffer (never past a page), which
+ * ASan would report.
+ */
+#if defined(__x86_64__) && !defined(__SANITIZE_ADDRESS__)
+#define PARSE_SIMD 1
+#include <immintrin.h>
+#endif
+
+/* Up to this many bytes are scanned one at a time before switching to whole vectors. */
+#define SHORT_SCAN AOC_PARSE_SHORT_SCAN
+
+#define MAX_NEEDLES 8
+
+#ifdef PARSE_SIMD
+/* Bit i is set if byte i of the aligned block equals one of the needles. */
+static inline u64 match_sse2(const char *block, const __m128i *needles, int count) {
+    __m128i bytes = _mm_load_si128((const __m128i *)block);
+    __m128i match = _mm_cmpeq_epi8(bytes, needles[0]);
+    for (int i = 1; i < count; i++) match = _mm_or_si128(match, _mm_cmpeq_epi8(bytes, needles[i]));
+    return (u32)_mm_movemask_epi8(match);
 }
 
-i64 aoc_parse_nonnegative(const char *buf, size_t *pos) {
-    aoc_parse_skip_ws(buf, pos);
+__attribute__((target("avx2"))) static inline u64 match_avx2(const char *block, const __m256i *needles, int count) {
+    __m256i bytes = _mm256_load_si256((const __m256i *)block);
+    __m256i match = _mm256_cmpeq_epi8(bytes, needles[0]);
+    for (int i = 1; i < count; i++) match = _mm256_or_si256(match, _mm256_cmpeq_epi8(bytes, needles[i]));
+    return (u32)_mm256_movemask_epi8(match);
+}
+
+__attribute__((target("avx512f,avx512bw"))) static inline u64 match_avx512(const char *block, const __m512i *needles,
+                                                                             int count) {
+    __m512i bytes = _mm512_load_si512((const void *)block);
+    u64 match = _mm512_cmpeq_epi8_mask(bytes, needles[0]);
+    for (int i = 1; i < count; i++) match |= _mm512_cmpeq_epi8_mask(bytes, needles[i]);
+    return match;
+}
+
+/* Bit i is set if byte i of the aligned block is a digit. */
+static inline u64 digits_sse2(const char *block) {
+    __m128i digits = _mm_sub_epi8(_mm_load_si128((const __m128i *)block), _mm_set1_epi8('0'));
+    return (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(digits, _mm_set1_epi8(9)), digits));
+}
+
+__attribute__((target("avx2"))) static inline u64 digits_avx2(const char *block) {
+    __m256i digits = _mm256_sub_epi8(_mm256_load_si256((const __m256i *)block), _mm256_set1_epi8('0'));
+    return (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_min_epu8(digits, _mm256_set1_epi8(9)), digits));
+}
+
+__attribute__((target("avx512f,avx512bw"))) static inline u64 digits_avx512(const char *block) {
+    __m512i digits = _mm512_sub_epi8(_mm512_load_si512((const void *)block), _mm512_set1_epi8('0'));
+    return _mm512_cmple_epu8_mask(digits, _mm512_set1_epi8(9));
+}
+
+/*
+ * Defines the scan kernels of one instruction set level. They return the
+ * offset of the first byte at or after `p` which is one of the `count` needles
+ * or, if `digits`, a digit (or, if `invert`, none of them). Only aligned
+ * vectors are loaded, so a scan never crosses into the next page before
+ * reaching a match. rfind_digit scans backwards from the end of `len` bytes
+ * and returns `len` if there is no digit.
+ *
+ * The generic scan is inlined into one function per use, since the kernels
+ * cannot be inlined into their (baseline) callers and the needle vectors
+ * should live in registers.
+ */
+#define DEFINE_SCAN(isa, features, width, Vec, splat)                                                                  \
+    __attribute__((target(features), always_inline)) static inline size_t scan_##isa(const char *p,                    \
+                                                                                     const char *needles, int count,   \
+                                                                                     bool invert, bool digits) {       \
+        Vec vecs[MAX_NEEDLES + 1];                                                                                     \
+        vecs[0] = splat(needles[0]);                                                                                   \
+        for (int i = 1; i < count; i++) vecs[i] = splat(needles[i]);                                                   \
+        u64 flip = invert ? ~0ull >> (64 - (width)) : 0;                                                               \
+        size_t misalignment = (uintptr_t)p % (width);                                                                  \
+        const char *block = p - misalignment;                                                                          \
+        u64 bits = ((match_##isa(block, vecs, count) | (digits ? digits_##isa(block) : 0)) ^ flip) &                  \
+                   (~0ull << misalignment);                                                                            \
+        while (bits == 0) {                                                                                            \
+            block += (width);                                                                                          \
+            bits = (match_##isa(block, vecs, count) | (digits ? digits_##isa(block) : 0)) ^ flip;                      \
+        }                                                                                                              \
+        return block - p + __builtin_ctzll(bits);                                                                      \
+    }                                                                                                                  \
+    __attribute__((target(features))) static size_t seek_##isa(const char *p, char needle) {                           \
+        const char needles[] = {needle, '\0'};                                                                         \
+        return scan_##isa(p, needles, 2, false, false);                                                                \
+    }                                                                                                                  \
+    __attribute__((target(features))) static size_t seek_any_##isa(const char *p, const char *needles, int count) {    \
+        return scan_##isa(p, needles, count, false, false);                                                            \
+    }                                                                                                                  \
+    __attribute__((target(features))) static size_t skip_##isa(const char *p, char c) {                                \
+        return scan_##isa(p, &c, 1, true, false);                                                                      \
+    }                                                                                                                  \
+    __attribute__((target(features))) static size_t seek_digit_##isa(const char *p, char stop) {                       \
+        const char needles[] = {stop, '\0'};                                                                           \
+        return scan_##isa(p, needles, 2, false, true);                                                                 \
+    }                                                                                                                  \
+    __attribute__((target(features))) static size_t rfind_digit_##isa(const char *p, size_t len) {                     \
+        size_t misalignment = (uintptr_t)(p + len - 1) % (width);                                                      \
+        const char *block = p + len - 1 - misalignment;                                                                \
+        u64 bits = digits_##isa(block) & (~0ull >> (63 - misalignment));                                               \
+        while (true) {                                                                                                 \
+            if (block <= p) bits &= ~0ull << (p - block);                                                              \
+            if (bits) return block - p + 63 - __builtin_clzll(bits);                                                   \
+            if (block <= p) return len;                                                                                \
+            block -= (width);                                                                                          \
+            bits = digits_##isa(block);                                                                                \
+        }                                                                                                              \
+    }
+
+DEFINE_SCAN(sse2, "sse2", 16, __m128i, _mm_set1_epi8)
+DEFINE_SCAN(avx2, "avx2", 32, __m256i, _mm256_set1_epi8)
+DEFINE_SCAN(avx512, "avx512f,avx512bw", 64, __m512i, _mm512_set1_epi8)
+
+/* Calls the `kernel` of the best instruction set level. */
+#define DISPATCH(kernel, ...)                                                                                          \
+    ({                                                                                                                 \
+        size_t _offset;                                                                                                \
+        switch (aoc_cpu_isa()) {                                                                                       \
+        case AOC_ISA_V4: _offset = kernel##_avx512(__VA_ARGS__); break;                                                \
+        case AOC_ISA_V3: _offset = kernel##_avx2(__VA_ARGS__); break;                                                  \
+        default: _offset = kernel##_sse2(__VA_ARGS__); break;                                                          \
+        }                                                                                                              \
+        _offset;                                                                                                       \
+    })
+#endif
+
+size_t aoc_parse_skip_ws_long(const char *buf, size_t pos) {
+#ifdef PARSE_SIMD
+    // '\0' is not a space either, so the scan stops at the end of the buffer
+    return pos + DISPATCH(skip, &buf[pos], ' ');
+#else
+    while (buf[pos] == ' ') pos++;
+    return pos;
+#endif
+}
+
+static inline bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+#ifdef PARSE_SIMD
+/* The smallest page size: a 16 byte load which does not cross a page boundary cannot fault. */
+#define MIN_PAGE_SIZE 4096
 
+static inline bool can_load16(const char *p) { return ((uintptr_t)p & (MIN_PAGE_SIZE - 1)) <= MIN_PAGE_SIZE - 16; }
+
+/* SWAR check whether the 8 bytes at `p` are digits, i.e. in 0x30..0x39. */
+static inline bool starts_with_8_digits(const char *p) {
+    u64 chunk;
+    memcpy(&chunk, p, sizeof(chunk));
+    return (chunk & 0xF0F0F0F0F0F0F0F0ull) == 0x3030303030303030ull &&
+           ((chunk + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) == 0x3030303030303030ull;
+}
+
+/* shuffle indices which move the first n bytes to the end and zero the others, see parse_digits16() */
+static const i8 align_right[32] = {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                   0,  1,  2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13, 14, 15};
+
+/*
+ * Converts the run of (up to 16) digits at the start of the 16 bytes at `p`:
+ * the digits are right-aligned and then combined pairwise into 2, 4, 8 and
+ * finally 16 digit numbers.
+ */
+__attribute__((target("sse4.1"))) static inline u64 parse_digits16(const char *p, size_t *count) {
+    __m128i digits = _mm_sub_epi8(_mm_loadu_si128((const __m128i *)p), _mm_set1_epi8('0'));
+    __m128i valid = _mm_cmpeq_epi8(_mm_min_epu8(digits, _mm_set1_epi8(9)), digits);
+    int n = __builtin_ctz(~_mm_movemask_epi8(valid)); // 16 if all bytes are digits
+    *count = n;
+
+    digits = _mm_shuffle_epi8(digits, _mm_loadu_si128((const __m128i *)&align_right[n]));
+    digits = _mm_maddubs_epi16(digits, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1));
+    digits = _mm_madd_epi16(digits, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+    digits = _mm_packus_epi32(digits, digits);
+    digits = _mm_madd_epi16(digits, _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1));
+    return (u64)(u32)_mm_cvtsi128_si32(digits) * 100000000 + (u32)_mm_extract_epi32(digits, 1);
+}
+#endif
+
+/* Parses the digits at *pos without skipping whitespace first. */
+static inline i64 parse_digits(const char *buf, size_t *pos) {
     i64 result = 0;
     size_t i = *pos;
+#ifdef PARSE_SIMD
+    // Only long numbers are converted at once: for short ones the well-predicted scalar loop runs ahead, while
+    // the vector code makes every number wait for the length of the previous one. The byte test is a cheap
+    // early out for the many one and two digit numbers.
+    if (can_load16(&buf[i]) && is_digit(buf[i + 2]) && starts_with_8_digits(&buf[i]) && aoc_cpu_isa() >= AOC_ISA_V2) {
+        size_t count;
+        result = parse_digits16(&buf[i], &count);
+        i += count; // the loop below continues numbers with more than 16 digits
+    }
+#endif
     while (buf[i] >= '0' && buf[i] <= '9') {
         result = (result * 10) + (buf[i] - '0');
         i++;
@@ -38,6 +222,11 @@ i64 aoc_parse_nonnegative(const char *buf, size_t *pos) {
     return result;
 }
 
+i64 aoc_parse_nonnegative(const char *buf, size_t *pos) {
+    aoc_parse_skip_ws(buf, pos);
+    return parse_digits(buf, pos);
+}
+
 bool aoc_parse_integer(const char *buf, size_t *pos, i64 *out) {
     aoc_parse_skip_ws(buf, pos);
     if (buf[*pos] == '-') {
@@ -54,9 +243,66 @@ bool aoc_parse_integer(const char *buf, size_t *pos, i64 *out) {
     return true;
 }
 
-void aoc_parse_seek(const char *buf, size_t *pos, char needle) {
-    int i = *pos;
-    while (buf[i] != needle) i++;
-    *pos = i;
-    assert(buf[*pos] == needle);
+size_t aoc_parse_integers(const char *buf, size_t *pos, i64 *out, size_t capacity) {
+    size_t count = 0;
+    while (count < capacity) {
+        aoc_parse_skip_ws(buf, pos);
+        size_t i = *pos;
+        bool negative = buf[i] == '-';
+        if (negative || buf[i] == '+') i++;
+        i64 value = parse_digits(buf, &i);
+        if (value < 0) break;
+        out[count++] = negative ? -value : value;
+        *pos = i;
+    }
+    return count;
+}
+
+size_t aoc_parse_seek_long(const char *buf, size_t pos, char needle) {
+#ifdef PARSE_SIMD
+    return pos + DISPATCH(seek, &buf[pos], needle);
+#else
+    while (buf[pos] != needle && buf[pos] != '\0') pos++;
+    return pos;
+#endif
+}
+
+size_t aoc_parse_seek_any_long(const char *buf, size_t pos, const char *needles) {
+#ifdef PARSE_SIMD
+    // the terminating '\0' is a needle, too
+    int count = strlen(needles) + 1;
+    assert(count <= MAX_NEEDLES + 1);
+    return pos + DISPATCH(seek_any, &buf[pos], needles, count);
+#else
+    while (buf[pos] != '\0' && strchr(needles, buf[pos]) == NULL) pos++;
+    return pos;
+#endif
+}
+
+size_t aoc_parse_seek_digit_long(const char *buf, size_t pos, char stop) {
+#ifdef PARSE_SIMD
+    return pos + DISPATCH(seek_digit, &buf[pos], stop);
+#else
+    while (!is_digit(buf[pos]) && buf[pos] != stop && buf[pos] != '\0') pos++;
+    return pos;
+#endif
+}
+
+size_t aoc_parse_rfind_digit(const char *buf, size_t begin, size_t end) {
+    size_t i = end, stop = end - begin > SHORT_SCAN ? end - SHORT_SCAN : begin;
+    while (i > stop) {
+        if (is_digit(buf[--i])) return i;
+    }
+#ifdef PARSE_SIMD
+    if (i > begin) {
+        size_t offset = DISPATCH(rfind_digit, &buf[begin], i - begin);
+        return offset < i - begin ? begin + offset : end;
+    }
+    return end;
+#else
+    while (i > begin) {
+        if (is_digit(buf[--i])) return i;
+    }
+    return end;
+#endif
 }
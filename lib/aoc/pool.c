@@ -0,0 +1,221 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "aoc/pool.h"
+
+typedef struct {
+    AocTaskFn fn;
+    void *arg;
+} Task;
+
+/* A growable ring buffer of tasks. */
+typedef struct {
+    pthread_mutex_t mutex;
+    Task *tasks;
+    size_t head, count, capacity;
+} Deque;
+
+typedef struct {
+    AocPool *pool;
+    int id;
+} Worker;
+
+struct AocPool {
+    int size;
+    pthread_t *threads;
+    Worker *workers;
+    Deque *deques;
+
+    atomic_size_t queued;  /* tasks sitting in a deque */
+    atomic_size_t pending; /* tasks submitted but not finished yet */
+    atomic_uint next;      /* round-robin counter of aoc_pool_submit() */
+
+    pthread_mutex_t mutex; /* protects `stop` and the condition variables */
+    pthread_cond_t work;   /* signaled when a task is queued or the pool stops */
+    pthread_cond_t idle;   /* signaled when `pending` drops to zero */
+    bool stop;
+};
+
+static void deque_push_back(Deque *d, Task task) {
+    pthread_mutex_lock(&d->mutex);
+    if (d->count == d->capacity) {
+        size_t capacity = d->capacity ? 2 * d->capacity : 64;
+        Task *tasks = malloc(capacity * sizeof(Task));
+        if (tasks == NULL) abort();
+        for (size_t i = 0; i < d->count; i++) tasks[i] = d->tasks[(d->head + i) % d->capacity];
+        free(d->tasks);
+        d->tasks = tasks;
+        d->head = 0;
+        d->capacity = capacity;
+    }
+    d->tasks[(d->head + d->count) % d->capacity] = task;
+    d->count++;
+    pthread_mutex_unlock(&d->mutex);
+}
+
+/* The owner takes the most recently queued task (LIFO). */
+static bool deque_pop_back(Deque *d, Task *task) {
+    pthread_mutex_lock(&d->mutex);
+    bool found = d->count > 0;
+    if (found) {
+        d->count--;
+        *task = d->tasks[(d->head + d->count) % d->capacity];
+    }
+    pthread_mutex_unlock(&d->mutex);
+    return found;
+}
+
+/* Thieves take the oldest task (FIFO). */
+static bool deque_pop_front(Deque *d, Task *task) {
+    pthread_mutex_lock(&d->mutex);
+    bool found = d->count > 0;
+    if (found) {
+        *task = d->tasks[d->head];
+        d->head = (d->head + 1) % d->capacity;
+        d->count--;
+    }
+    pthread_mutex_unlock(&d->mutex);
+    return found;
+}
+
+static bool take_task(AocPool *pool, int id, Task *task) {
+    if (deque_pop_back(&pool->deques[id], task)) return true;
+    for (int i = 1; i < pool->size; i++) {
+        if (deque_pop_front(&pool->deques[(id + i) % pool->size], task)) return true;
+    }
+    return false;
+}
+
+/* Set on the worker threads of all pools. */
+static _Thread_local bool in_worker;
+
+bool aoc_pool_in_worker(void) { return in_worker; }
+
+static void *worker_main(void *arg) {
+    Worker *worker = arg;
+    AocPool *pool = worker->pool;
+    in_worker = true;
+    while (1) {
+        Task task;
+        if (take_task(pool, worker->id, &task)) {
+            atomic_fetch_sub(&pool->queued, 1);
+            task.fn(task.arg, worker->id);
+            if (atomic_fetch_sub(&pool->pending, 1) == 1) {
+                pthread_mutex_lock(&pool->mutex);
+                pthread_cond_broadcast(&pool->idle);
+                pthread_mutex_unlock(&pool->mutex);
+            }
+            continue;
+        }
+
+        pthread_mutex_lock(&pool->mutex);
+        while (atomic_load(&pool->queued) == 0 && !pool->stop) pthread_cond_wait(&pool->work, &pool->mutex);
+        bool stop = pool->stop && atomic_load(&pool->queued) == 0;
+        pthread_mutex_unlock(&pool->mutex);
+        if (stop) break;
+    }
+    return NULL;
+}
+
+static void pool_free(AocPool *pool) {
+    if (pool->deques != NULL) {
+        for (int i = 0; i < pool->size; i++) {
+            free(pool->deques[i].tasks);
+            pthread_mutex_destroy(&pool->deques[i].mutex);
+        }
+    }
+    free(pool->deques);
+    free(pool->workers);
+    free(pool->threads);
+    pthread_cond_destroy(&pool->idle);
+    pthread_cond_destroy(&pool->work);
+    pthread_mutex_destroy(&pool->mutex);
+    free(pool);
+}
+
+static void pool_stop(AocPool *pool, int started) {
+    pthread_mutex_lock(&pool->mutex);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->work);
+    pthread_mutex_unlock(&pool->mutex);
+    for (int i = 0; i < started; i++) pthread_join(pool->threads[i], NULL);
+}
+
+AocPool *aoc_pool_create(int threads) {
+    if (threads <= 0) threads = sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads <= 0) threads = 1;
+
+    AocPool *pool = calloc(1, sizeof(*pool));
+    if (pool == NULL) return NULL;
+    pool->size = threads;
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->work, NULL);
+    pthread_cond_init(&pool->idle, NULL);
+    pool->threads = calloc(threads, sizeof(pthread_t));
+    pool->workers = calloc(threads, sizeof(Worker));
+    pool->deques = calloc(threads, sizeof(Deque));
+    if (pool->threads == NULL || pool->workers == NULL || pool->deques == NULL) {
+        pool_free(pool);
+        return NULL;
+    }
+    for (int i = 0; i < threads; i++) pthread_mutex_init(&pool->deques[i].mutex, NULL);
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, AOC_POOL_STACK_SIZE);
+    for (int i = 0; i < threads; i++) {
+        pool->workers[i] = (Worker){.pool = pool, .id = i};
+        if (pthread_create(&pool->threads[i], &attr, worker_main, &pool->workers[i]) != 0) {
+            perror("Error starting worker thread");
+            pthread_attr_destroy(&attr);
+            pool_stop(pool, i);
+            pool_free(pool);
+            return NULL;
+        }
+    }
+    pthread_attr_destroy(&attr);
+    return pool;
+}
+
+int aoc_pool_size(const AocPool *pool) { return pool->size; }
+
+void aoc_pool_submit_to(AocPool *pool, int worker, AocTaskFn fn, void *arg) {
+    atomic_fetch_add(&pool->pending, 1);
+    atomic_fetch_add(&pool->queued, 1);
+    deque_push_back(&pool->deques[worker % pool->size], (Task){.fn = fn, .arg = arg});
+
+    pthread_mutex_lock(&pool->mutex);
+    pthread_cond_signal(&pool->work);
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+void aoc_pool_submit(AocPool *pool, AocTaskFn fn, void *arg) {
+    aoc_pool_submit_to(pool, atomic_fetch_add(&pool->next, 1) % pool->size, fn, arg);
+}
+
+void aoc_pool_wait(AocPool *pool) {
+    pthread_mutex_lock(&pool->mutex);
+    while (atomic_load(&pool->pending) != 0) pthread_cond_wait(&pool->idle, &pool->mutex);
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+void aoc_pool_destroy(AocPool **pool) {
+    AocPool *p = *pool;
+    if (p == NULL) return;
+    aoc_pool_wait(p);
+    pool_stop(p, p->size);
+    pool_free(p);
+    *pool = NULL;
+}
@@ -16,10 +16,10 @@ void aoc_strreverse(char *begin, char *end) {
 }
 
 size_t aoc_itoa(i64 value, char *out, int base) {
-    static char num[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+    static const char num[] = "0123456789abcdefghijklmnopqrstuvwxyz";
 
     char *wstr = out;
-    int sign;
+    i64 sign;
 
     // Validate base
     assert(base >= 2 && base <= 35);
@@ -0,0 +1,58 @@
+#!/usr/bin/env bash
+#
+# Training run of a build configured with -Db_pgo=generate (`ninja pgo-train`).
+#
+# Runs every day on its input in input/, or on a generated one (see `gen`) if
+# there is none or it is still encrypted (git-crypt), and leaves the profile
+# where -Db_pgo=use looks for it: gcc writes the .gcda files next to the
+# objects by itself, clang's raw profiles are merged into default.profdata in
+# the build directory. The inputs used are collected in pgo-inputs/ of the
+# build directory, so that `bench --inputs` can measure on the same ones.
+#
+# Every day is repeated until it ran for about PGO_TRAIN_SECONDS (default: 1).
+# Otherwise the slow days dominate the profile and the compiler optimizes the
+# fast ones for size, as if they were cold code.
+#
+# Usage: pgo-train.sh AOC GEN COMPILER_ID [LLVM_PROFDATA]
+
+set -euo pipefail
+
+aoc=$1
+gen=$2
+compiler=$3
+profdata=${4:-llvm-profdata}
+target_us=$(awk "BEGIN { print int(${PGO_TRAIN_SECONDS:-1} * 1000000) }")
+build=${MESON_BUILD_ROOT:?must be run by meson}
+source=${MESON_SOURCE_ROOT:?must be run by meson}
+inputs="$build/pgo-inputs"
+profiles="$build/pgo-profiles"
+
+rm -rf "$inputs" "$profiles"
+mkdir -p "$inputs" "$profiles"
+if [[ $compiler == clang ]]; then
+    export LLVM_PROFILE_FILE="$profiles/%p.profraw"
+else
+    # gcc adds to existing counters, so start from scratch
+    find "$build" -name '*.gcda' -delete
+fi
+
+for day in $("$gen" --list | awk 'NR > 1 { print $1 }'); do
+    real="$source/input/$day.txt"
+    if [[ -s $real ]] && [[ $(head -c 9 "$real" | tr -d '\0') != GITCRYPT ]]; then
+        ln -s "$real" "$inputs/$day.txt"
+    else
+        "$gen" --output "$inputs/$day.txt" "$day"
+    fi
+    start=${EPOCHREALTIME/./}
+    "$aoc" --input "$inputs/$day.txt" "$day" >/dev/null
+    elapsed_us=$((${EPOCHREALTIME/./} - start + 1))
+    repetitions=$((target_us / elapsed_us))
+    echo "pgo-train: $day ($(readlink -f "$inputs/$day.txt")), $((repetitions + 1)) runs"
+    if ((repetitions > 0)); then
+        "$aoc" --bench "$repetitions" --input "$inputs/$day.txt" "$day" >/dev/null
+    fi
+done
+
+if [[ $compiler == clang ]]; then
+    "$profdata" merge --output="$build/default.profdata" "$profiles"/*.profraw
+fi
@@ -0,0 +1,37 @@
+#!/usr/bin/env bash
+#
+# Generates the solver versions of the result cache (src/runner/cache.h).
+#
+# The version of a day is a hash of its sources (src/DAY/ without the tests)
+# and of the code shared by all days (include/, lib/aoc/ and vendor/, again
+# without tests), so that any change which might change a result invalidates
+# the cached ones. The hashed files are written to DEPFILE, so ninja
+# regenerates OUTPUT when they change.
+#
+# Usage: solver-versions.sh OUTPUT DEPFILE SOURCE_ROOT DAY...
+
+set -euo pipefail
+
+output=$1
+depfile=$2
+cd "$3"
+shift 3
+
+common=$(find include lib/aoc vendor -type f \( -name '*.c' -o -name '*.h' \) ! -name '*_test.c' | LC_ALL=C sort)
+all_files=$common
+{
+    echo "#pragma once"
+    echo
+    echo "/* generated by scripts/solver-versions.sh */"
+    for day in "$@"; do
+        files=$(find "src/$day" -type f \( -name '*.c' -o -name '*.h' \) ! -name '*_test.c' | LC_ALL=C sort)
+        # shellcheck disable=SC2086 # file names do not contain spaces
+        version=$(sha256sum $files $common | sha256sum | cut -c1-16)
+        echo "#define AOC_SOLVER_VERSION_$day 0x${version}ull"
+        all_files+=" $files"
+    done
+} >"$output"
+
+printf '%s:' "$output" >"$depfile"
+for f in $all_files; do printf ' %s' "$PWD/$f" >>"$depfile"; done
+echo >>"$depfile"
@@ -0,0 +1,149 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <dirent.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "aoc/io.h"
+#include "aoc/macros.h"
+#include "aoc/pool.h"
+#include "aoc/time.h"
+#include "batch.h"
+
+typedef struct {
+    char **items;
+    size_t count, capacity;
+} PathList;
+
+static void path_list_add(PathList *list, const char *path) {
+    if (list->count == list->capacity) {
+        list->capacity = list->capacity ? 2 * list->capacity : 256;
+        list->items = realloc(list->items, list->capacity * sizeof(char *));
+        if (list->items == NULL) abort();
+    }
+    list->items[list->count++] = strdup(path);
+}
+
+static void path_list_free(PathList *list) {
+    for (size_t i = 0; i < list->count; i++) free(list->items[i]);
+    free(list->items);
+}
+
+static int compare_paths(const void *a, const void *b) { return strcmp(*(char *const *)a, *(char *const *)b); }
+
+static int collect_directory(const char *dir, PathList *paths) {
+    DIR *d = opendir(dir);
+    if (d == NULL) {
+        perror(dir);
+        return -1;
+    }
+    struct dirent *entry;
+    while ((entry = readdir(d)) != NULL) {
+        char path[PATH_MAX];
+        snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name);
+        struct stat st;
+        if (stat(path, &st) == 0 && S_ISREG(st.st_mode)) path_list_add(paths, path);
+    }
+    closedir(d);
+    qsort(paths->items, paths->count, sizeof(char *), compare_paths);
+    return 0;
+}
+
+static void collect_lines(FILE *f, PathList *paths) {
+    char *line = NULL;
+    size_t line_capacity = 0;
+    ssize_t len;
+    while ((len = getline(&line, &line_capacity, f)) != -1) {
+        while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r')) line[--len] = '\0';
+        if (len > 0) path_list_add(paths, line);
+    }
+    free(line);
+}
+
+static int collect_paths(const char *list, PathList *paths) {
+    if (strcmp(list, "-") == 0) {
+        collect_lines(stdin, paths);
+        return 0;
+    }
+    struct stat st;
+    if (stat(list, &st) == 0 && S_ISDIR(st.st_mode)) return collect_directory(list, paths);
+    FILE *f = fopen(list, "r");
+    if (f == NULL) {
+        perror(list);
+        return -1;
+    }
+    collect_lines(f, paths);
+    fclose(f);
+    return 0;
+}
+
+typedef struct {
+    AocSolveFn solve;
+    AocBuffer *buffers; /* one per worker */
+} BatchContext;
+
+typedef struct {
+    const BatchContext *ctx;
+    const char *path;
+    Solution solution;
+    int rc;
+} BatchItem;
+
+static void solve_item(void *arg, int worker) {
+    BatchItem *item = arg;
+    AocBuffer *buffer = &item->ctx->buffers[worker];
+    item->rc = aoc_io_read_into(item->path, buffer);
+    if (item->rc == 0) item->ctx->solve(buffer->buf, buffer->size, &item->solution);
+}
+
+int aoc_batch_run(const char *list, int jobs, AocSolveFn solve) {
+    PathList paths = {0};
+    if (collect_paths(list, &paths)) return -1;
+
+    AocPool *pool = aoc_pool_create(jobs);
+    if (pool == NULL) {
+        path_list_free(&paths);
+        return -1;
+    }
+    int workers = aoc_pool_size(pool);
+    BatchContext ctx = {.solve = solve, .buffers = calloc(workers, sizeof(AocBuffer))};
+    BatchItem *items = calloc(MAX(paths.count, (size_t)1), sizeof(BatchItem));
+    if (ctx.buffers == NULL || items == NULL) abort();
+
+    u64 start = aoc_time_now_ns();
+    for (size_t i = 0; i < paths.count; i++) {
+        items[i] = (BatchItem){.ctx = &ctx, .path = paths.items[i]};
+        aoc_pool_submit(pool, solve_item, &items[i]);
+    }
+    aoc_pool_wait(pool);
+    double elapsed = (aoc_time_now_ns() - start) / 1e9;
+    aoc_pool_destroy(&pool);
+
+    int rc = 0;
+    for (size_t i = 0; i < paths.count; i++) {
+        const BatchItem *item = &items[i];
+        if (item->rc != 0) {
+            printf("%s\terror\n", item->path);
+            rc = -1;
+        } else {
+            printf("%s\t%s\t%s\n", item->path, item->solution.part1, item->solution.part2);
+        }
+    }
+    fprintf(stderr, "%zu inputs in %.3f s (%.0f inputs/s, %d threads)\n", paths.count, elapsed,
+            elapsed > 0 ? paths.count / elapsed : 0.0, workers);
+
+    for (int i = 0; i < workers; i++) aoc_io_buffer_free(&ctx.buffers[i]);
+    free(ctx.buffers);
+    free(items);
+    path_list_free(&paths);
+    return rc;
+}
@@ -0,0 +1,30 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#include "solve.h"
+
+typedef void (*AocSolveFn)(char *buf, size_t buf_size, Solution *result);
+
+/**
+ * Solves many inputs in parallel on a work-stealing thread pool.
+ *
+ * Every worker reads its inputs into a buffer which it reuses for all of
+ * them. One line `<path>\t<part1>\t<part2>` is printed per input, in the
+ * order of `list` (`<path>\terror` if the input could not be read).
+ *
+ * @param list A directory (all regular files in it, sorted by name), a file
+ * containing one path per line, or "-" to read such a list from stdin.
+ * @param jobs The number of worker threads, or one per CPU if not positive.
+ *
+ * @return 0 if all inputs were solved, a negative value otherwise.
+ */
+int aoc_batch_run(const char *list, int jobs, AocSolveFn solve);
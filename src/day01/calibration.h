@@ -0,0 +1,21 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#include "aoc/types.h"
+
+/**
+ * Adds the calibration values of `buf`, which must end with a newline, to
+ * `part1` and `part2`. The buffer is split after newlines into `count`
+ * chunks, which are summed on a pool of `threads` workers, or on the calling
+ * thread if `threads` is at most 1.
+ */
+void calibration_sum_chunked(const char *buf, size_t buf_size, size_t count, int threads, i64 *part1, i64 *part2);
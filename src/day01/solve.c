@@ -10,70 +10,224 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
 #include "aoc/all.h"
+#include "calibration.h"
 #include "solve.h"
 
-static const char ONE[] = {'o', 'n', 'e'};
-static const char TWO[] = {'t', 'w', 'o'};
-static const char THREE[] = {'t', 'h', 'r', 'e', 'e'};
-static const char FOUR[] = {'f', 'o', 'u', 'r'};
-static const char FIVE[] = {'f', 'i', 'v', 'e'};
-static const char SIX[] = {'s', 'i', 'x'};
-static const char SEVEN[] = {'s', 'e', 'v', 'e', 'n'};
-static const char EIGHT[] = {'e', 'i', 'g', 'h', 't'};
-static const char NINE[] = {'n', 'i', 'n', 'e'};
+/*
+ * Part 1 only needs the first and the last digit of a line: both are found
+ * with the vectorized scans of aoc/parser.h, the latter by scanning backwards
+ * from the newline. Part 2 runs an Aho-Corasick automaton over the
+ * spelled-out digits on the bytes in front of the first digit, and a second
+ * one over the reversed words on the bytes behind the last digit. No word is
+ * a substring of another, so the first match of either automaton is the
+ * wanted one.
+ */
 
-void solve(char *buf, size_t buf_size, Solution *result) {
-    int part1 = 0, part2 = 0;
+static const char *const WORDS[] = {"one", "two", "three", "four", "five", "six", "seven", "eight", "nine"};
+
+#define STATES 40 /* the root and one state per letter of WORDS */
+
+/* Aho-Corasick automaton over WORDS, as a DFA on the letters 'a'..'z'. */
+typedef struct {
+    u8 next[STATES][26];
+    u8 value[STATES]; /* the digit recognized on entering a state, 0 if none */
+} Automaton;
+
+typedef struct {
+    Automaton forward;
+    Automaton backward; /* over the reversed words */
+} Words;
+
+static void automaton_build(Automaton *automaton, bool reverse) {
+    memset(automaton, 0, sizeof(*automaton));
+    int states = 1;
+    for (int digit = 1; digit <= 9; digit++) {
+        const char *word = WORDS[digit - 1];
+        int len = strlen(word), state = 0;
+        for (int i = 0; i < len; i++) {
+            int c = (reverse ? word[len - 1 - i] : word[i]) - 'a';
+            if (automaton->next[state][c] == 0) automaton->next[state][c] = states++;
+            state = automaton->next[state][c];
+        }
+        automaton->value[state] = digit;
+    }
+    assert(states <= STATES);
+
+    // breadth-first, so that the failure state of a state is complete before its children are visited
+    u8 fail[STATES] = {0}, queue[STATES];
+    int head = 0, tail = 0;
+    for (int c = 0; c < 26; c++) {
+        if (automaton->next[0][c]) queue[tail++] = automaton->next[0][c];
+    }
+    while (head < tail) {
+        int state = queue[head++];
+        if (automaton->value[state] == 0) automaton->value[state] = automaton->value[fail[state]];
+        for (int c = 0; c < 26; c++) {
+            int child = automaton->next[state][c];
+            if (child) {
+                fail[child] = automaton->next[fail[state]][c];
+                queue[tail++] = child;
+            } else {
+                automaton->next[state][c] = automaton->next[fail[state]][c];
+            }
+        }
+    }
+}
+
+static void words_init(Words *words) {
+    automaton_build(&words->forward, false);
+    automaton_build(&words->backward, true);
+}
+
+/* The digit of the first word in buf[from, to), or 0. */
+static int first_word(const Automaton *automaton, const char *buf, size_t from, size_t to) {
+    for (int state = 0; from < to; from++) {
+        unsigned c = (u8)buf[from] - 'a';
+        state = c < 26 ? automaton->next[state][c] : 0;
+        if (automaton->value[state]) return automaton->value[state];
+    }
+    return 0;
+}
+
+/* The digit of the last word in buf[from, to), or 0. */
+static int last_word(const Automaton *automaton, const char *buf, size_t from, size_t to) {
+    for (int state = 0; to > from; to--) {
+        unsigned c = (u8)buf[to - 1] - 'a';
+        state = c < 26 ? automaton->next[state][c] : 0;
+        if (automaton->value[state]) return automaton->value[state];
+    }
+    return 0;
+}
+
+/* Adds up the calibration values of the lines in `buf`, which must end with a newline. */
+static void sum_calibration_values(const Words *words, const char *buf, size_t buf_size, i64 *part1, i64 *part2) {
     size_t pos = 0;
-    int digits[64] = {0}, digits2[64] = {0};
-    int alpha = 0, beta = 0;
     while (pos < buf_size) {
-        int value = buf[pos];
-        if (value >= '0' && value <= '9') {
-            digits[alpha++] = value - '0';
-            digits2[beta++] = value - '0';
-        } else if (value >= 'a' && value <= 'z') {
-            //  attempt to parse word
-            if (pos + sizeof(ONE) < buf_size && memcmp(&buf[pos], ONE, sizeof(ONE)) == 0) {
-                digits2[beta++] = 1;
-            } else if (pos + sizeof(TWO) < buf_size && memcmp(&buf[pos], TWO, sizeof(TWO)) == 0) {
-                digits2[beta++] = 2;
-            } else if (pos + sizeof(THREE) < buf_size && memcmp(&buf[pos], THREE, sizeof(THREE)) == 0) {
-                digits2[beta++] = 3;
-            } else if (pos + sizeof(FOUR) < buf_size && memcmp(&buf[pos], FOUR, sizeof(FOUR)) == 0) {
-                digits2[beta++] = 4;
-            } else if (pos + sizeof(FIVE) < buf_size && memcmp(&buf[pos], FIVE, sizeof(FIVE)) == 0) {
-                digits2[beta++] = 5;
-            } else if (pos + sizeof(SIX) < buf_size && memcmp(&buf[pos], SIX, sizeof(SIX)) == 0) {
-                digits2[beta++] = 6;
-            } else if (pos + sizeof(SEVEN) < buf_size && memcmp(&buf[pos], SEVEN, sizeof(SEVEN)) == 0) {
-                digits2[beta++] = 7;
-            } else if (pos + sizeof(EIGHT) < buf_size && memcmp(&buf[pos], EIGHT, sizeof(EIGHT)) == 0) {
-                digits2[beta++] = 8;
-            } else if (pos + sizeof(NINE) < buf_size && memcmp(&buf[pos], NINE, sizeof(NINE)) == 0) {
-                digits2[beta++] = 9;
-            }
-        } else if (value == '\n') {
-            part1 += digits[0] * 10 + digits[MAX(0, alpha - 1)];
-            part2 += digits2[0] * 10 + digits2[MAX(0, beta - 1)];
-            // reset state
-            alpha = 0, beta = 0;
+        // words are searched in buf[pos, first) and buf[after_last, end)
+        size_t first = pos;
+        aoc_parse_seek_digit(buf, &first, '\n');
+        size_t end = first, after_last = pos;
+        int first_digit = 0, last_digit = 0;
+        if (buf[first] != '\n') {
+            end = first + 1;
+            aoc_parse_seek(buf, &end, '\n');
+            size_t last = aoc_parse_rfind_digit(buf, first, end);
+            first_digit = buf[first] - '0';
+            last_digit = buf[last] - '0';
+            after_last = last + 1;
         }
-        pos++;
+        *part1 += first_digit * 10 + last_digit;
+
+        int head = first_word(&words->forward, buf, pos, first);
+        int tail = last_word(&words->backward, buf, after_last, end);
+        *part2 += (head ? head : first_digit) * 10 + (tail ? tail : last_digit);
+        pos = end + 1;
+    }
+}
+
+/*
+ * Inputs of at least this size are split at newlines into one chunk per
+ * thread, but no chunk is smaller than half of it. Lines are independent, so
+ * the chunks are summed in parallel and the sums added up. Summing is memory
+ * bound, so a few threads suffice. If solve() already runs on a pool worker
+ * (aoc --parallel, batch or serve mode) the caller uses the cores, and the
+ * input is summed sequentially.
+ */
+#define PARALLEL_THRESHOLD (16 << 20)
+#define PARALLEL_MAX_THREADS 8
+
+typedef struct {
+    const Words *words;
+    const char *buf;
+    size_t size;
+    i64 part1, part2;
+} Chunk;
+
+static void sum_chunk(void *arg, _unused_ int worker) {
+    Chunk *chunk = arg;
+    sum_calibration_values(chunk->words, chunk->buf, chunk->size, &chunk->part1, &chunk->part2);
+}
+
+/* Splits `buf` after newlines into `count` chunks of about the same size; some may be empty. */
+static void split_chunks(const Words *words, const char *buf, size_t buf_size, Chunk *chunks, size_t count) {
+    size_t start = 0;
+    for (size_t i = 0; i < count; i++) {
+        size_t end = buf_size;
+        if (i + 1 < count) {
+            size_t target = MAX(start, buf_size / count * (i + 1));
+            const char *newline = target < buf_size ? memchr(&buf[target], '\n', buf_size - target) : NULL;
+            end = newline ? (size_t)(newline - buf) + 1 : buf_size;
+        }
+        chunks[i] = (Chunk){.words = words, .buf = &buf[start], .size = end - start};
+        start = end;
+    }
+}
+
+void calibration_sum_chunked(const char *buf, size_t buf_size, size_t count, int threads, i64 *part1, i64 *part2) {
+    Words words;
+    words_init(&words);
+    Chunk *chunks = calloc(count, sizeof(Chunk));
+    _cleanup_(aoc_pool_destroy) AocPool *pool = threads > 1 && chunks ? aoc_pool_create(threads) : NULL;
+    if (chunks == NULL) {
+        sum_calibration_values(&words, buf, buf_size, part1, part2);
+        return;
+    }
+    split_chunks(&words, buf, buf_size, chunks, count);
+    for (size_t i = 0; i < count; i++) {
+        if (pool) {
+            aoc_pool_submit(pool, sum_chunk, &chunks[i]);
+        } else {
+            sum_chunk(&chunks[i], 0);
+        }
+    }
+    if (pool) aoc_pool_wait(pool);
+    for (size_t i = 0; i < count; i++) {
+        *part1 += chunks[i].part1;
+        *part2 += chunks[i].part2;
+    }
+    free(chunks);
+}
+
+void solve(char *buf, size_t buf_size, Solution *result) {
+    i64 part1 = 0, part2 = 0;
+    if (buf_size >= PARALLEL_THRESHOLD && !aoc_pool_in_worker()) {
+        size_t threads = MIN((size_t)sysconf(_SC_NPROCESSORS_ONLN), (size_t)PARALLEL_MAX_THREADS);
+        threads = MAX(MIN(threads, buf_size / (PARALLEL_THRESHOLD / 2)), (size_t)1);
+        calibration_sum_chunked(buf, buf_size, threads, threads, &part1, &part2);
+    } else {
+        Words words;
+        words_init(&words);
+        sum_calibration_values(&words, buf, buf_size, &part1, &part2);
     }
     aoc_itoa(part1, result->part1, 10);
     aoc_itoa(part2, result->part2, 10);
 }
 
+int solve_stream(AocStream *stream, Solution *result) {
+    Words words;
+    words_init(&words);
+    i64 part1 = 0, part2 = 0;
+    char *chunk;
+    size_t chunk_size;
+    while (aoc_stream_next(stream, &chunk, &chunk_size)) {
+        sum_calibration_values(&words, chunk, chunk_size, &part1, &part2);
+    }
+    if (aoc_stream_error(stream)) return -1;
+    aoc_itoa(part1, result->part1, 10);
+    aoc_itoa(part2, result->part2, 10);
+    return 0;
+}
+
 int solve_input(const char *fname, Solution *result) {
-    char buf[1 << 15];
-    int n = aoc_io_read_input(fname, buf, sizeof(buf));
-    if (n <= 0) {
+    _cleanup_(aoc_io_unmap_input) AocInput input;
+    if (aoc_io_map_input(fname, &input)) {
         fprintf(stderr, "Failed to read %s\n", fname);
         return -1;
     }
-    solve(buf, n, result);
+    solve(input.buf, input.size, result);
     return 0;
 }
@@ -8,6 +8,9 @@
 
 #define CTEST_MAIN
 
+#include "aoc/io.h"
+#include "aoc/testing.h"
+#include "calibration.h"
 #include "ctest.h"
 #include "solve.h"
 
@@ -22,6 +25,17 @@ treb7uchet\n";
     ASSERT_STR("142", solution.part2);
 }
 
+CTEST(day01, stream) {
+    const char *buf = "1abc2\n\
+pqr3stu8vwx\n\
+a1b2c3d4e5f\n\
+treb7uchet\n";
+    Solution solution;
+    ASSERT_EQUAL(0, aoc_test_solve_stream(buf, &solution));
+    ASSERT_STR("142", solution.part1);
+    ASSERT_STR("142", solution.part2);
+}
+
 CTEST(day01, example2) {
     const char *buf = "two1nine\n\
 eightwothree\n\
@@ -35,6 +49,30 @@ zoneight234\n\
     ASSERT_STR("281", solution.part2);
 }
 
+CTEST(day01, long_lines) {
+    // more than 64 digits on a line, and words overlapping at both ends
+    const char *buf = "oneightx1234567890123456789012345678901234567890123456789012345678901234567890sevenine\n\
+nodigits\n\
+twone\n";
+    Solution solution;
+    solve(buf, strlen(buf), &solution);
+    ASSERT_STR("10", solution.part1);
+    ASSERT_STR("40", solution.part2);
+}
+
+CTEST(day01, chunked) {
+    const char *buf = "two1nine\neightwothree\nabcone2threexyz\nxtwone3four\n4nineeightseven2\nzoneight234\n";
+    // more chunks than lines, so that some are empty, and both with and without a pool
+    for (size_t count = 1; count <= 8; count++) {
+        for (int threads = 1; threads <= 3; threads += 2) {
+            i64 part1 = 0, part2 = 0;
+            calibration_sum_chunked(buf, strlen(buf), count, threads, &part1, &part2);
+            ASSERT_EQUAL(132, part1);
+            ASSERT_EQUAL(205, part2);
+        }
+    }
+}
+
 #ifdef HAVE_INPUTS
 CTEST(day01, real) {
     Solution solution;
@@ -0,0 +1,272 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "aoc/macros.h"
+#include "aoc/parser.h"
+#include "games.h"
+
+/* Input bytes parsed at a time by games_parse_log(). */
+#define SEGMENT_SIZE (64 << 10)
+
+/* Games checked against all bags at once; 4 arrays of 4 bytes each, i.e. 16 KiB. */
+#define BLOCK 1024
+
+static void *resize(void *ptr, size_t size) {
+    ptr = realloc(ptr, size);
+    if (ptr == NULL) {
+        fprintf(stderr, "day02: out of memory\n");
+        abort();
+    }
+    return ptr;
+}
+
+/* The shortest game is "Game 1: 1 red\n", the shortest draw "1 red" plus a separator. */
+#define MIN_GAME_BYTES 14
+#define MIN_DRAW_BYTES 6
+
+static const u8 WORD_LENGTH[COLOURS] = {[RED] = 3, [GREEN] = 5, [BLUE] = 4};
+
+static void draws_reserve(Draws *draws, size_t capacity) {
+    if (capacity <= draws->capacity) return;
+    draws->capacity = capacity;
+    draws->game = resize(draws->game, capacity * sizeof(u32));
+    draws->colour = resize(draws->colour, capacity * sizeof(u8));
+    draws->count = resize(draws->count, capacity * sizeof(u32));
+}
+
+static void games_reserve(Games *games, size_t capacity) {
+    if (capacity <= games->capacity) return;
+    games->capacity = capacity;
+    games->id = resize(games->id, capacity * sizeof(u32));
+    for (int c = 0; c < COLOURS; c++) games->max[c] = resize(games->max[c], capacity * sizeof(u32));
+}
+
+static void draws_push(Draws *draws, u32 game, Colour colour, u32 count) {
+    if (draws->size == draws->capacity) draws_reserve(draws, draws->capacity ? 2 * draws->capacity : 256);
+    draws->game[draws->size] = game;
+    draws->colour[draws->size] = colour;
+    draws->count[draws->size] = count;
+    draws->size++;
+}
+
+static u32 games_push(Games *games, u32 id) {
+    if (games->size == games->capacity) games_reserve(games, games->capacity ? 2 * games->capacity : 64);
+    games->id[games->size] = id;
+    for (int c = 0; c < COLOURS; c++) games->max[c][games->size] = 0;
+    return games->size++;
+}
+
+void games_parse(const char *buf, size_t buf_size, Draws *draws, Games *games) {
+    size_t pos = 0;
+    while (pos < buf_size) {
+        // "Game <id>:"
+        while (!(buf[pos] >= '0' && buf[pos] <= '9')) pos++;
+        u32 game = games_push(games, aoc_parse_nonnegative(buf, &pos));
+        pos++;
+        while (true) {
+            aoc_parse_skip_ws(buf, &pos);
+            u32 count = aoc_parse_nonnegative(buf, &pos);
+            aoc_parse_skip_ws(buf, &pos);
+            // "red", "green" or "blue": the first letter tells the colour and so the length of the word
+            Colour colour = buf[pos] == 'r' ? RED : buf[pos] == 'g' ? GREEN : BLUE;
+            draws_push(draws, game, colour, count);
+            pos += WORD_LENGTH[colour];
+            // ',' and ';' both just separate draws
+            if (buf[pos++] == '\n') break;
+        }
+    }
+}
+
+void games_reduce(const Draws *draws, Games *games) {
+    for (size_t i = 0; i < draws->size; i++) {
+        u32 *max = &games->max[draws->colour[i]][draws->game[i]];
+        *max = MAX(*max, draws->count[i]);
+    }
+}
+
+void games_parse_log(const char *buf, size_t buf_size, Games *games) {
+    _cleanup_(draws_free) Draws draws = {0};
+    // sized once from the length of the log, as no game or draw is shorter than MIN_GAME_BYTES or MIN_DRAW_BYTES
+    games_reserve(games, games->size + buf_size / MIN_GAME_BYTES + 1);
+    draws_reserve(&draws, MIN(buf_size, (size_t)SEGMENT_SIZE) / MIN_DRAW_BYTES + 1);
+    size_t start = 0;
+    while (start < buf_size) {
+        size_t end = buf_size;
+        if (buf_size - start > SEGMENT_SIZE) {
+            const char *newline = memchr(&buf[start + SEGMENT_SIZE], '\n', buf_size - start - SEGMENT_SIZE);
+            if (newline) end = newline - buf + 1;
+        }
+        draws.size = 0;
+        games_parse(&buf[start], end - start, &draws, games);
+        games_reduce(&draws, games);
+        start = end;
+    }
+}
+
+/* The loops below are plain enough to be auto-vectorized. */
+void games_evaluate(const Games *games, const Bag *bags, size_t bag_count, i64 *id_sums, i64 *power) {
+    const u32 *id = games->id, *red = games->max[RED], *green = games->max[GREEN], *blue = games->max[BLUE];
+    for (size_t start = 0; start < games->size; start += BLOCK) {
+        size_t end = MIN(games->size, start + BLOCK);
+        u64 block_power = 0;
+        for (size_t i = start; i < end; i++) block_power += (u64)red[i] * green[i] * blue[i];
+        *power += block_power;
+
+        for (size_t b = 0; b < bag_count; b++) {
+            u32 max_red = bags[b].cubes[RED], max_green = bags[b].cubes[GREEN], max_blue = bags[b].cubes[BLUE];
+            u64 sum = 0;
+            for (size_t i = start; i < end; i++) {
+                bool possible = (red[i] <= max_red) & (green[i] <= max_green) & (blue[i] <= max_blue);
+                sum += possible ? id[i] : 0;
+            }
+            id_sums[b] += sum;
+        }
+    }
+}
+
+/* Largest prefix sum table game_index_build() creates: 2^21 cells, i.e. 16 MiB. */
+#define MAX_INDEX_CELLS (1 << 21)
+
+/* Maxima below this are ranked with a lookup table instead of sorting them. */
+#define DENSE_LIMIT (1 << 16)
+
+static int compare_u32(const void *lhs, const void *rhs) {
+    u32 a = *(const u32 *)lhs, b = *(const u32 *)rhs;
+    return (a > b) - (a < b);
+}
+
+/* Number of values <= `value`, i.e. the rank of `value` plus one if it occurs. */
+static size_t upper_bound(const u32 *values, size_t count, u32 value) {
+    size_t lo = 0, hi = count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (values[mid] <= value) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/*
+ * Collects the distinct values of `max` into `values`, ascending. If they are
+ * all below DENSE_LIMIT, `rank` receives the table value -> 1 + its index in
+ * `values`; otherwise it is set to NULL and the values are sorted.
+ */
+static int compress(const u32 *max, size_t size, u32 *values, size_t *count, u32 **rank) {
+    u32 largest = 0;
+    for (size_t i = 0; i < size; i++) largest = MAX(largest, max[i]);
+    *rank = NULL;
+    *count = 0;
+    if (largest < DENSE_LIMIT) {
+        u32 *table = calloc(largest + 1, sizeof(u32));
+        if (table == NULL) return -1;
+        for (size_t i = 0; i < size; i++) table[max[i]] = 1;
+        for (u32 v = 0; v <= largest; v++) {
+            if (table[v]) {
+                values[(*count)++] = v;
+                table[v] = *count;
+            }
+        }
+        *rank = table;
+        return 0;
+    }
+    memcpy(values, max, size * sizeof(u32));
+    qsort(values, size, sizeof(u32), compare_u32);
+    for (size_t i = 0; i < size; i++) {
+        if (*count == 0 || values[*count - 1] != values[i]) values[(*count)++] = values[i];
+    }
+    return 0;
+}
+
+/* Fills the prefix sum table of `index`, unless it would be too large. */
+static int build_sums(GameIndex *index, const Games *games, u32 *const rank[COLOURS]) {
+    size_t nr = index->count[RED] + 1, ng = index->count[GREEN] + 1, nb = index->count[BLUE] + 1;
+    if (nr > MAX_INDEX_CELLS / ng / nb) return 0; // too sparse, queries scan the games
+    index->sums = calloc(nr * ng * nb, sizeof(u64));
+    if (index->sums == NULL) return -1;
+    u64 *sums = index->sums;
+#define CELL(r, g, b) sums[((r) * ng + (g)) * nb + (b)]
+#define RANK(c, i)                                                                                                     \
+    (rank[c] ? rank[c][games->max[c][i]] : upper_bound(index->values[c], index->count[c], games->max[c][i]))
+    // a game is counted by all cells at or above the ranks of its maxima (plus one, row 0 stays empty)
+    for (size_t i = 0; i < games->size; i++) CELL(RANK(RED, i), RANK(GREEN, i), RANK(BLUE, i)) += games->id[i];
+#undef RANK
+    for (size_t r = 1; r < nr; r++) {
+        for (size_t g = 0; g < ng; g++) {
+            for (size_t b = 0; b < nb; b++) CELL(r, g, b) += CELL(r - 1, g, b);
+        }
+    }
+    for (size_t r = 0; r < nr; r++) {
+        for (size_t g = 1; g < ng; g++) {
+            for (size_t b = 0; b < nb; b++) CELL(r, g, b) += CELL(r, g - 1, b);
+        }
+    }
+    for (size_t r = 0; r < nr; r++) {
+        for (size_t g = 0; g < ng; g++) {
+            for (size_t b = 1; b < nb; b++) CELL(r, g, b) += CELL(r, g, b - 1);
+        }
+    }
+#undef CELL
+    return 0;
+}
+
+int game_index_build(GameIndex *index, const Games *games) {
+    *index = (GameIndex){.games = games};
+    u32 *rank[COLOURS] = {NULL};
+    int rc = 0;
+    for (int c = 0; c < COLOURS && rc == 0; c++) {
+        index->values[c] = malloc(MAX(games->size, (size_t)1) * sizeof(u32));
+        rc = index->values[c] ? compress(games->max[c], games->size, index->values[c], &index->count[c], &rank[c]) : -1;
+    }
+    if (rc == 0) rc = build_sums(index, games, rank);
+    for (int c = 0; c < COLOURS; c++) free(rank[c]);
+    if (rc) game_index_free(index);
+    return rc;
+}
+
+void game_index_query(const GameIndex *index, const Bag *bags, size_t bag_count, i64 *id_sums) {
+    if (index->sums == NULL) {
+        i64 power = 0;
+        memset(id_sums, 0, bag_count * sizeof(i64));
+        games_evaluate(index->games, bags, bag_count, id_sums, &power);
+        return;
+    }
+    size_t ng = index->count[GREEN] + 1, nb = index->count[BLUE] + 1;
+    for (size_t i = 0; i < bag_count; i++) {
+        size_t r = upper_bound(index->values[RED], index->count[RED], bags[i].cubes[RED]);
+        size_t g = upper_bound(index->values[GREEN], index->count[GREEN], bags[i].cubes[GREEN]);
+        size_t b = upper_bound(index->values[BLUE], index->count[BLUE], bags[i].cubes[BLUE]);
+        id_sums[i] = index->sums[(r * ng + g) * nb + b];
+    }
+}
+
+void draws_free(Draws *draws) {
+    free(draws->game);
+    free(draws->colour);
+    free(draws->count);
+    *draws = (Draws){0};
+}
+
+void games_free(Games *games) {
+    free(games->id);
+    for (int c = 0; c < COLOURS; c++) free(games->max[c]);
+    *games = (Games){0};
+}
+
+void game_index_free(GameIndex *index) {
+    for (int c = 0; c < COLOURS; c++) free(index->values[c]);
+    free(index->sums);
+    *index = (GameIndex){0};
+}
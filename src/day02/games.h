@@ -0,0 +1,96 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#include "aoc/types.h"
+
+typedef enum { RED, GREEN, BLUE, COLOURS } Colour;
+
+/* Every handful of cubes shown in any game: `count[i]` cubes of `colour[i]` in game `game[i]`. */
+typedef struct {
+    u32 *game; /* index into Games */
+    u8 *colour;
+    u32 *count;
+    size_t size, capacity;
+} Draws;
+
+/* Per game, the most cubes of each colour shown at once. */
+typedef struct {
+    u32 *id;
+    u32 *max[COLOURS];
+    size_t size, capacity;
+} Games;
+
+/* How many cubes of each colour a bag holds. */
+typedef struct {
+    u32 cubes[COLOURS];
+} Bag;
+
+/**
+ * Parses the game records in `buf`, which must end with a newline: appends
+ * the games with all maxima 0 to `games` and their draws to `draws`.
+ */
+void games_parse(const char *buf, size_t buf_size, Draws *draws, Games *games);
+
+/**
+ * Raises the maxima of `games` to the counts of `draws`.
+ */
+void games_reduce(const Draws *draws, Games *games);
+
+/**
+ * Appends the games of the log in `buf`, which must end with a newline, to
+ * `games` with their maxima. The log is parsed and reduced in segments, so
+ * that the draws stay in the cache.
+ */
+void games_parse_log(const char *buf, size_t buf_size, Games *games);
+
+/**
+ * Adds the ids of the games which are possible with `bags[i]` to
+ * `id_sums[i]`, and the power of every game to `power`.
+ *
+ * The games are visited once, in blocks small enough to stay in L1 while all
+ * bags are checked against them.
+ */
+void games_evaluate(const Games *games, const Bag *bags, size_t bag_count, i64 *id_sums, i64 *power);
+
+/**
+ * Answers many bag queries against the same games.
+ *
+ * The maxima of every colour are compressed to their ranks among the
+ * distinct maxima, and sums[r][g][b] holds the sum of the ids of all games
+ * whose maxima have ranks below (r, g, b). A query is then three binary
+ * searches and one lookup. If there are too many distinct maxima for such a
+ * table, queries fall back to games_evaluate().
+ */
+typedef struct {
+    const Games *games;
+    u32 *values[COLOURS];   /* the distinct maxima of each colour, ascending */
+    size_t count[COLOURS];  /* number of values */
+    u64 *sums;              /* (count[RED] + 1) x (count[GREEN] + 1) x (count[BLUE] + 1), or NULL */
+} GameIndex;
+
+/**
+ * Builds an index over `games`, which must outlive it and not change.
+ *
+ * @return 0 on success, -1 if out of memory.
+ */
+int game_index_build(GameIndex *index, const Games *games);
+
+/**
+ * Stores the sum of the ids of the games which are possible with `bags[i]`
+ * in `id_sums[i]`.
+ */
+void game_index_query(const GameIndex *index, const Bag *bags, size_t bag_count, i64 *id_sums);
+
+/* Suitable for use with _cleanup_(). */
+void draws_free(Draws *draws);
+void games_free(Games *games);
+void game_index_free(GameIndex *index);
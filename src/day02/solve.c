@@ -11,62 +11,45 @@
 #include <stdlib.h>
 
 #include "aoc/all.h"
+#include "games.h"
 #include "solve.h"
 
-void solve(char *buf, size_t buf_size, Solution *result) {
-    int part1 = 0, part2 = 0;
-    size_t pos = 0;
-    int game_id = 1;
-    while (pos < buf_size) {
-        log_debug("Game %d", game_id);
-        bool game_ok = true;
-        long red_min = 0, green_min = 0, blue_min = 0;
-        while (pos < buf_size && buf[pos] != ':') pos++;
-        while (true) {
-            aoc_parse_skip_ws(buf, &pos);
-            int amount = aoc_parse_nonnegative(buf, &pos);
-            aoc_parse_skip_ws(buf, &pos);
-            if (buf[pos] == 'r') {
-                log_debug("red %d", amount);
-                red_min = MAX(red_min, amount);
-                if (amount > 12) game_ok = false;
-            } else if (buf[pos] == 'g') {
-                log_debug("green %d", amount);
-                green_min = MAX(green_min, amount);
-                if (amount > 13) game_ok = false;
-            } else if (buf[pos] == 'b') {
-                log_debug("blue %d", amount);
-                blue_min = MAX(blue_min, amount);
-                if (amount > 14) game_ok = false;
-            }
-            // skip word
-            while (buf[pos] >= 'a' && buf[pos] <= 'z') pos++;
-            if (buf[pos] == '\n') {
-                if (game_ok) part1 += game_id;
-                log_debug("min rgb: %d %d %d", red_min, green_min, blue_min);
-                part2 += red_min * green_min * blue_min;
-                pos++;
-                game_id++;
-                break;
-            } else if (buf[pos] == ';') {
-                log_debug("next set");
-            }
-            pos++;
-        }
-        pos++;
-    }
+/* The bag of the puzzle: 12 red, 13 green and 14 blue cubes. */
+static const Bag BAG = {.cubes = {[RED] = 12, [GREEN] = 13, [BLUE] = 14}};
 
+/*
+ * One bag is answered by a single pass over the games; game_index_build()
+ * only pays off for callers with many bags.
+ */
+static void answer(const Games *games, Solution *result) {
+    i64 part1 = 0, part2 = 0;
+    games_evaluate(games, &BAG, 1, &part1, &part2);
     aoc_itoa(part1, result->part1, 10);
     aoc_itoa(part2, result->part2, 10);
 }
 
+void solve(char *buf, size_t buf_size, Solution *result) {
+    _cleanup_(games_free) Games games = {0};
+    games_parse_log(buf, buf_size, &games);
+    answer(&games, result);
+}
+
+int solve_stream(AocStream *stream, Solution *result) {
+    _cleanup_(games_free) Games games = {0};
+    char *chunk;
+    size_t chunk_size;
+    while (aoc_stream_next(stream, &chunk, &chunk_size)) games_parse_log(chunk, chunk_size, &games);
+    if (aoc_stream_error(stream)) return -1;
+    answer(&games, result);
+    return 0;
+}
+
 int solve_input(const char *fname, Solution *result) {
-    char buf[1 << 14];
-    int n = aoc_io_read_input(fname, buf, sizeof(buf));
-    if (n <= 0) {
+    _cleanup_(aoc_io_unmap_input) AocInput input;
+    if (aoc_io_map_input(fname, &input)) {
         fprintf(stderr, "Failed to read %s\n", fname);
         return -1;
     }
-    solve(buf, n, result);
+    solve(input.buf, input.size, result);
     return 0;
 }
@@ -8,7 +8,10 @@
 
 #define CTEST_MAIN
 
+#include "aoc/io.h"
+#include "aoc/testing.h"
 #include "ctest.h"
+#include "games.h"
 #include "solve.h"
 
 CTEST(day02, example) {
@@ -23,6 +26,76 @@ Game 5: 6 red, 1 blue, 3 green; 2 blue, 1 red, 2 green\n";
     ASSERT_STR("2286", solution.part2);
 }
 
+CTEST(day02, stream) {
+    const char *buf = "Game 1: 3 blue, 4 red; 1 red, 2 green, 6 blue; 2 green\n\
+Game 2: 1 blue, 2 green; 3 green, 4 blue, 1 red; 1 green, 1 blue\n\
+Game 3: 8 green, 6 blue, 20 red; 5 blue, 4 red, 13 green; 5 green, 1 red\n\
+Game 4: 1 green, 3 red, 6 blue; 3 green, 6 red; 3 green, 15 blue, 14 red\n\
+Game 5: 6 red, 1 blue, 3 green; 2 blue, 1 red, 2 green\n";
+    Solution solution;
+    ASSERT_EQUAL(0, aoc_test_solve_stream(buf, &solution));
+    ASSERT_STR("8", solution.part1);
+    ASSERT_STR("2286", solution.part2);
+}
+
+CTEST(day02, bags) {
+    const char *buf = "Game 1: 3 blue, 4 red; 1 red, 2 green, 6 blue; 2 green\n\
+Game 2: 1 blue, 2 green; 3 green, 4 blue, 1 red; 1 green, 1 blue\n\
+Game 3: 8 green, 6 blue, 20 red; 5 blue, 4 red, 13 green; 5 green, 1 red\n\
+Game 4: 1 green, 3 red, 6 blue; 3 green, 6 red; 3 green, 15 blue, 14 red\n\
+Game 5: 6 red, 1 blue, 3 green; 2 blue, 1 red, 2 green\n";
+    Draws draws = {0};
+    Games games = {0};
+    games_parse(buf, strlen(buf), &draws, &games);
+    games_reduce(&draws, &games);
+    const Bag bags[] = {{.cubes = {12, 13, 14}}, {.cubes = {20, 13, 15}}, {.cubes = {6, 3, 6}}};
+    i64 id_sums[3] = {0}, power = 0;
+    games_evaluate(&games, bags, 3, id_sums, &power);
+    ASSERT_EQUAL(8, id_sums[0]);
+    ASSERT_EQUAL(15, id_sums[1]);
+    ASSERT_EQUAL(8, id_sums[2]);
+    ASSERT_EQUAL(2286, power);
+    draws_free(&draws);
+    games_free(&games);
+}
+
+static u32 next_random(u64 *state) {
+    *state = *state * 6364136223846793005ull + 1;
+    return *state >> 33;
+}
+
+CTEST(day02, index) {
+    // few distinct maxima give a prefix sum table, many make the queries fall back to scanning, and large ones
+    // are ranked by sorting instead of a lookup table
+    for (u32 range = 20; range <= 200000; range *= 100) {
+        Games games = {0};
+        u64 state = 42;
+        for (u32 id = 1; id <= 300; id++) {
+            Draws draws = {0};
+            char line[64];
+            u32 red = next_random(&state) % range, green = next_random(&state) % range;
+            u32 blue = next_random(&state) % range;
+            int len = snprintf(line, sizeof(line), "Game %u: %u red, %u green; %u blue\n", id, red, green, blue);
+            games_parse(line, len, &draws, &games);
+            games_reduce(&draws, &games);
+            draws_free(&draws);
+        }
+        GameIndex index;
+        ASSERT_EQUAL(0, game_index_build(&index, &games));
+        ASSERT_TRUE((index.sums != NULL) == (range == 20));
+        Bag bags[64];
+        for (int i = 0; i < 64; i++) {
+            for (int c = 0; c < COLOURS; c++) bags[i].cubes[c] = next_random(&state) % (range + 2);
+        }
+        i64 expected[64] = {0}, actual[64], power = 0;
+        games_evaluate(&games, bags, 64, expected, &power);
+        game_index_query(&index, bags, 64, actual);
+        for (int i = 0; i < 64; i++) ASSERT_EQUAL(expected[i], actual[i]);
+        game_index_free(&index);
+        games_free(&games);
+    }
+}
+
 #ifdef HAVE_INPUTS
 CTEST(day02, real) {
     Solution solution;
@@ -9,92 +9,135 @@
 #include "solve.h"
 #include "aoc/all.h"
 
-#define MAX_NUMBERS 150
-#define MAX_SYMBOLS 4096
-#define EMPTY -1
+/*
+ * The schematic is processed in a single pass over its rows. Every number
+ * gets a label, unique within its row, in a buffer of the row's width with an
+ * empty column on either side; the rows above the first and below the last
+ * are empty, too. The symbols of a row are handled once the row below is
+ * labelled and only look up the labels of the 3x3 cells around them, so three
+ * row buffers suffice for a schematic of any size and there are no bounds
+ * checks.
+ */
 
 typedef struct {
-    int x;
-    int y;
-    char value;
-} Symbol;
-
-static inline bool is_symbol(char s) { return !(s >= '0' && s <= '9') && s != '.'; }
+    const char *line; /* NULL for the empty rows around the schematic */
+    u32 *label;       /* cols + 2 cells; label[x + 1] is 1 + the index of the number at column x, or 0 */
+    u64 *value;       /* the numbers of the row */
+    bool *counted;    /* whether a number was added to part 1 already */
+    u32 *symbols;     /* the columns of the symbols */
+    size_t symbol_count;
+} Row;
 
-static inline int collect(int8_t numbers[MAX_NUMBERS][MAX_NUMBERS], int cols, int candidate_x, int candidate_y) {
-    // go left as far as possible to find start digit
-    while (candidate_x - 1 >= 0 && numbers[candidate_y][candidate_x - 1] != EMPTY) { candidate_x--; }
-    int value = numbers[candidate_y][candidate_x];
-    // reset to prevent collecting twice
-    numbers[candidate_y][candidate_x] = EMPTY;
-    for (int i = candidate_x + 1; i < cols; i++) {
-        if (numbers[candidate_y][i] == EMPTY) break;
-        value *= 10;
-        value += numbers[candidate_y][i];
-        numbers[candidate_y][i] = EMPTY;
+static void row_alloc(Row *row, int cols) {
+    size_t numbers = cols / 2 + 1;
+    row->label = calloc(cols + 2, sizeof(u32));
+    row->value = malloc(numbers * sizeof(u64));
+    row->counted = malloc(numbers * sizeof(bool));
+    row->symbols = malloc((cols + 1) * sizeof(u32));
+    if (row->label == NULL || row->value == NULL || row->counted == NULL || row->symbols == NULL) {
+        fprintf(stderr, "day03: out of memory\n");
+        abort();
     }
-    return value;
+    row->line = NULL;
+    row->symbol_count = 0;
 }
 
-void solve(char *buf, size_t buf_size, Solution *result) {
-    int cols = 0;
-    while (buf[cols] != '\n') cols++;
-    int rows = 0;
+static void row_free(Row *row) {
+    free(row->label);
+    free(row->value);
+    free(row->counted);
+    free(row->symbols);
+}
 
-    int8_t numbers[MAX_NUMBERS][MAX_NUMBERS];
-    memset(numbers, EMPTY, sizeof(numbers));
-    Symbol symbols[MAX_SYMBOLS];
-    size_t symbols_idx = 0;
+static void row_clear(Row *row, int cols) {
+    row->line = NULL;
+    row->symbol_count = 0;
+    memset(row->label, 0, (cols + 2) * sizeof(u32));
+}
 
-    size_t pos = 0;
-    while (pos < buf_size) {
-        for (int x = 0; x < cols; x++) {
-            if (is_symbol(buf[pos])) {
-                Symbol s = {.x = x, .y = rows, .value = buf[pos]};
-                symbols[symbols_idx++] = s;
-            } else if (buf[pos] >= '0' && buf[pos] <= '9') {
-                numbers[rows][x] = buf[pos] - '0';
+static void row_label(Row *row, const char *line, int cols) {
+    u32 *label = row->label + 1, numbers = 0;
+    row->line = line;
+    row->symbol_count = 0;
+    for (int x = 0; x < cols; x++) {
+        char c = line[x];
+        if (c >= '0' && c <= '9') {
+            if (label[x - 1] == 0) {
+                row->value[numbers] = 0;
+                row->counted[numbers] = false;
+                numbers++;
             }
-            pos++;
-        }
-        if (pos < buf_size && buf[pos] == '\n') {
-            rows++;
-            pos++;
+            row->value[numbers - 1] = row->value[numbers - 1] * 10 + (c - '0');
+            label[x] = numbers;
+        } else {
+            label[x] = 0;
+            if (c != '.') row->symbols[row->symbol_count++] = x;
         }
     }
+}
 
-    int part1 = 0, part2 = 0;
-    for (size_t i = 0; i < symbols_idx; i++) {
-        int y = symbols[i].y, x = symbols[i].x;
-        bool is_star = symbols[i].value == '*';
+/* Adds the numbers around the symbol at column `x` of window[1] to part 1, and its gear ratio to part 2. */
+static void visit_symbol(Row *window[3], u32 x, i64 *part1, i64 *part2) {
+    int adjacent = 0;
+    i64 ratio = 1;
+    for (int dy = 0; dy < 3; dy++) {
+        Row *row = window[dy];
+        const u32 *label = &row->label[x]; // columns x - 1, x and x + 1
+        for (int dx = 0; dx < 3; dx++) {
+            u32 number = label[dx];
+            // a number spans consecutive cells
+            if (number == 0 || (dx > 0 && label[dx - 1] == number)) continue;
+            number--;
+            if (!row->counted[number]) {
+                row->counted[number] = true;
+                *part1 += row->value[number];
+            }
+            adjacent++;
+            ratio *= row->value[number];
+        }
+    }
+    if (window[1]->line[x] == '*' && adjacent == 2) *part2 += ratio;
+}
 
-        int values[8];
-        int value_idx = 0;
+void solve(char *buf, size_t buf_size, Solution *result) {
+    int cols = 0;
+    while (buf[cols] != '\n') cols++;
 
-        Point2D deltas[] = {{-1, -1}, {0, -1}, {1, -1}, {-1, 0}, {1, 0}, {-1, 1}, {0, 1}, {1, 1}};
+    Row rows[3];
+    for (int i = 0; i < 3; i++) row_alloc(&rows[i], cols);
+    Row *window[3] = {&rows[0], &rows[1], &rows[2]};
 
-        for (size_t i = 0; i < ARRAY_LENGTH(deltas); i++) {
-            int candidate_x = x + deltas[i].x, candidate_y = y + deltas[i].y;
-            if (candidate_x >= 0 && candidate_y >= 0 && candidate_x < cols && candidate_y < rows &&
-                numbers[candidate_y][candidate_x] != EMPTY) {
-                values[value_idx++] = collect(numbers, cols, candidate_x, candidate_y);
-            }
+    i64 part1 = 0, part2 = 0;
+    size_t pos = 0;
+    row_label(window[1], buf, cols);
+    pos += cols + 1;
+    while (window[1]->line != NULL) {
+        if (pos + cols <= buf_size) {
+            row_label(window[2], &buf[pos], cols);
+            pos += cols + 1;
+        } else {
+            row_clear(window[2], cols);
+        }
+        for (size_t i = 0; i < window[1]->symbol_count; i++) {
+            visit_symbol(window, window[1]->symbols[i], &part1, &part2);
         }
-        for (int i = 0; i < value_idx; i++) { part1 += values[i]; }
-        if (is_star && value_idx == 2) { part2 += values[0] * values[1]; }
+        Row *oldest = window[0];
+        window[0] = window[1];
+        window[1] = window[2];
+        window[2] = oldest;
     }
 
+    for (int i = 0; i < 3; i++) row_free(&rows[i]);
     aoc_itoa(part1, result->part1, 10);
     aoc_itoa(part2, result->part2, 10);
 }
 
 int solve_input(const char *fname, Solution *result) {
-    char buf[1 << 15];
-    int n = aoc_io_read_input(fname, buf, sizeof(buf));
-    if (n <= 0) {
+    _cleanup_(aoc_io_unmap_input) AocInput input;
+    if (aoc_io_map_input(fname, &input)) {
         fprintf(stderr, "Failed to read %s\n", fname);
         return -1;
     }
-    solve(buf, n, result);
+    solve(input.buf, input.size, result);
     return 0;
 }
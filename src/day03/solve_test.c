@@ -28,6 +28,21 @@ CTEST(day03, example) {
     ASSERT_STR("467835", solution.part2);
 }
 
+CTEST(day03, wide) {
+    // wider than 150 columns, and the 2 belongs to both gears
+    char buf[3 * 301 + 1];
+    memset(buf, '.', sizeof(buf) - 1);
+    buf[sizeof(buf) - 1] = '\0';
+    for (int y = 0; y < 3; y++) buf[y * 301 + 300] = '\n';
+    memcpy(&buf[301 + 200], "1*2*3", 5);
+    memcpy(&buf[2 * 301 + 295], "45", 2);
+    buf[301 + 296] = '#';
+    Solution solution;
+    solve(buf, strlen(buf), &solution);
+    ASSERT_STR("51", solution.part1);
+    ASSERT_STR("8", solution.part2);
+}
+
 #ifdef HAVE_INPUTS
 CTEST(day03, real) {
     Solution solution;
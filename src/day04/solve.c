@@ -10,29 +10,46 @@
 #include "aoc/all.h"
 
 // forward decl (to speed up incremental compilation)
-void int_tim_sort(int *dst, const size_t size);
+void i64_tim_sort(i64 *dst, const size_t size);
 
-void solve(char *buf, size_t buf_size, Solution *result) {
-    int part1 = 0, part2 = 0, card_id = 1, tmp;
-    int copies[256] = {0};
+// a card wins at most as many cards as it has winning numbers
+#define MAX_WINNING 16
+#define COPIES_LEN 32 // power of two > MAX_WINNING
+
+typedef struct {
+    i64 part1, part2;
+    i64 card_id;
+    // copies of the upcoming cards, indexed by card_id % COPIES_LEN
+    i64 copies[COPIES_LEN];
+} state_t;
+
+/* Processes the cards in `buf`, which must end with a newline. */
+static void process_cards(state_t *state, char *buf, size_t buf_size, Solution *result) {
+    i64 card_id = state->card_id, *copies = state->copies;
     size_t pos = 0;
 
     while (pos < buf_size) {
-        copies[card_id]++;
-        int wc[16], mc[32], wc_count = 0, mc_count = 0;
+        i64 instances = ++copies[card_id % COPIES_LEN];
+        copies[card_id % COPIES_LEN] = 0;
+        state->part2 += instances;
+        i64 wc[MAX_WINNING], mc[32];
+        int wc_count, mc_count;
 
-        aoc_parse_seek(buf, &pos, ':');
-        pos++;
+        { // parser
+            TIME_PHASE(result, parse);
+            aoc_parse_seek(buf, &pos, ':');
+            pos++;
 
-        while ((tmp = aoc_parse_nonnegative(buf, &pos)) >= 0) { wc[wc_count++] = tmp; }
+            wc_count = aoc_parse_integers(buf, &pos, wc, MAX_WINNING);
 
-        aoc_parse_seek(buf, &pos, '|');
-        pos++;
+            aoc_parse_seek(buf, &pos, '|');
+            pos++;
 
-        while ((tmp = aoc_parse_nonnegative(buf, &pos)) >= 0) { mc[mc_count++] = tmp; }
+            mc_count = aoc_parse_integers(buf, &pos, mc, ARRAY_LENGTH(mc));
+        }
 
-        int_tim_sort(wc, wc_count);
-        int_tim_sort(mc, mc_count);
+        i64_tim_sort(wc, wc_count);
+        i64_tim_sort(mc, mc_count);
         int match_count = 0;
         for (int i = 0, j = 0; i < wc_count && j < mc_count;) {
             if (wc[i] == mc[j]) {
@@ -44,27 +61,40 @@ void solve(char *buf, size_t buf_size, Solution *result) {
             }
         }
         if (match_count > 0) {
-            part1 += 1 << (match_count - 1);
-            int instances = copies[card_id];
-            for (int c = card_id + 1; c <= card_id + match_count; c++) { copies[c] += instances; }
+            state->part1 += 1 << (match_count - 1);
+            for (i64 c = card_id + 1; c <= card_id + match_count; c++) { copies[c % COPIES_LEN] += instances; }
         }
 
         pos++; // newline
         card_id++;
     }
-    for (size_t i = 0; i < ARRAY_LENGTH(copies); i++) { part2 += copies[i]; }
+    state->card_id = card_id;
+}
 
-    aoc_itoa(part1, result->part1, 10);
-    aoc_itoa(part2, result->part2, 10);
+void solve(char *buf, size_t buf_size, Solution *result) {
+    state_t state = {.card_id = 1};
+    process_cards(&state, buf, buf_size, result);
+    aoc_itoa(state.part1, result->part1, 10);
+    aoc_itoa(state.part2, result->part2, 10);
+}
+
+int solve_stream(AocStream *stream, Solution *result) {
+    state_t state = {.card_id = 1};
+    char *chunk;
+    size_t chunk_size;
+    while (aoc_stream_next(stream, &chunk, &chunk_size)) { process_cards(&state, chunk, chunk_size, result); }
+    if (aoc_stream_error(stream)) return -1;
+    aoc_itoa(state.part1, result->part1, 10);
+    aoc_itoa(state.part2, result->part2, 10);
+    return 0;
 }
 
 int solve_input(const char *fname, Solution *result) {
-    char buf[1 << 15];
-    int n = aoc_io_read_input(fname, buf, sizeof(buf));
-    if (n <= 0) {
+    _cleanup_(aoc_io_unmap_input) AocInput input;
+    if (aoc_io_map_input(fname, &input)) {
         fprintf(stderr, "Failed to read %s\n", fname);
         return -1;
     }
-    solve(buf, n, result);
+    solve(input.buf, input.size, result);
     return 0;
 }
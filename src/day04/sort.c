@@ -6,7 +6,9 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
-#define SORT_NAME int
-#define SORT_TYPE int
-#define SORT_CMP(x, y) ((x) - (y))
+#include "aoc/types.h"
+
+#define SORT_NAME i64
+#define SORT_TYPE i64
+#define SORT_CMP(x, y) ((x) < (y) ? -1 : (x) > (y))
 #include "sort.h"
@@ -72,50 +72,52 @@ void solve(char *buf, size_t buf_size, Solution *result) {
     Recipe recipes[32] = {0};
     Recipe inv_recipes[32] = {0};
 
-    size_t pos = 0;
-    aoc_parse_seek(buf, &pos, ':');
-    pos++;
-
-    i64 tmp;
-    while ((tmp = aoc_parse_nonnegative(buf, &pos)) >= 0) { seeds[seeds_count++] = tmp; }
-
-    while (pos < buf_size) {
-        while (buf[pos] == '\n') pos++;
+    { // parser
+        TIME_PHASE(result, parse);
+        size_t pos = 0;
+        aoc_parse_seek(buf, &pos, ':');
+        pos++;
 
-        size_t start = pos;
-        while (buf[pos] != '-') pos++;
-        size_t end = pos;
-        str from = str_ref_chars(&buf[start], end - start);
+        seeds_count = aoc_parse_integers(buf, &pos, seeds, ARRAY_LENGTH(seeds));
 
-        pos += 4; // skip "-to-"
+        while (pos < buf_size) {
+            while (buf[pos] == '\n') pos++;
 
-        start = pos;
-        while (buf[pos] != ' ') pos++;
-        end = pos;
-        str to = str_ref_chars(&buf[start], end - start);
+            size_t start = pos;
+            while (buf[pos] != '-') pos++;
+            size_t end = pos;
+            str from = str_ref_chars(&buf[start], end - start);
 
-        aoc_parse_seek(buf, &pos, '\n');
-        pos++;
+            pos += 4; // skip "-to-"
 
-        recipes[recipe_count].from = from;
-        recipes[recipe_count].to = to;
-        inv_recipes[recipe_count].from = to;
-        inv_recipes[recipe_count].to = from;
-        while (buf[pos] >= '0' && buf[pos] <= '9') {
-            u16 idx = recipes[recipe_count].map_len;
-            Map *map = &recipes[recipe_count].maps[idx];
-            map->dst = aoc_parse_nonnegative(buf, &pos);
-            map->src = aoc_parse_nonnegative(buf, &pos);
-            map->len = aoc_parse_nonnegative(buf, &pos);
-            recipes[recipe_count].map_len++;
-
-            idx = inv_recipes[recipe_count].map_len;
-            inv_recipes[recipe_count].maps[idx] = Map_invert(map);
-            inv_recipes[recipe_count].map_len++;
+            start = pos;
+            while (buf[pos] != ' ') pos++;
+            end = pos;
+            str to = str_ref_chars(&buf[start], end - start);
 
+            aoc_parse_seek(buf, &pos, '\n');
             pos++;
+
+            recipes[recipe_count].from = from;
+            recipes[recipe_count].to = to;
+            inv_recipes[recipe_count].from = to;
+            inv_recipes[recipe_count].to = from;
+            while (buf[pos] >= '0' && buf[pos] <= '9') {
+                u16 idx = recipes[recipe_count].map_len;
+                Map *map = &recipes[recipe_count].maps[idx];
+                i64 values[3];
+                aoc_parse_integers(buf, &pos, values, 3);
+                map->dst = values[0], map->src = values[1], map->len = values[2];
+                recipes[recipe_count].map_len++;
+
+                idx = inv_recipes[recipe_count].map_len;
+                inv_recipes[recipe_count].maps[idx] = Map_invert(map);
+                inv_recipes[recipe_count].map_len++;
+
+                pos++;
+            }
+            recipe_count++;
         }
-        recipe_count++;
     }
 
     str start = str_lit("seed");
@@ -138,39 +140,44 @@ void solve(char *buf, size_t buf_size, Solution *result) {
         }
     }
 
-    for (u16 i = 0; i < seeds_count; i++) {
-        i64 value = seeds[i];
-        for (size_t j = 0; j < optimal_path_index_count; j++) {
-            Recipe *r = &recipes[optimal_path_index[j]];
-            value = Recipe_lookup(r, value);
-        }
-        if (value < part1) {
-            log_debug("new best seed: %ld", seeds[i]);
-            part1 = value;
+    { // part 1
+        TIME_PHASE(result, part1);
+        for (u16 i = 0; i < seeds_count; i++) {
+            i64 value = seeds[i];
+            for (size_t j = 0; j < optimal_path_index_count; j++) {
+                Recipe *r = &recipes[optimal_path_index[j]];
+                value = Recipe_lookup(r, value);
+            }
+            if (value < part1) {
+                log_debug("new best seed: %ld", seeds[i]);
+                part1 = value;
+            }
         }
     }
 
-    // part 2
-    Interval interval[32];
-    size_t interval_count = 0;
-    for (int i = 0; i + 1 < seeds_count; i += 2) {
-        Interval inter = {.from = seeds[i], .to = seeds[i] + seeds[i + 1] - 1};
-        interval[interval_count++] = inter;
-    }
-
-    // reverse search: location to seed
     i64 part2 = 0;
-    for (i64 location = 1; part2 == 0; location++) {
-        i64 seed = location;
-        for (int j = optimal_path_index_count - 1; j >= 0; j--) {
-            Recipe *r = &inv_recipes[optimal_path_index[j]];
-            seed = Recipe_lookup(r, seed);
+    { // part 2
+        TIME_PHASE(result, part2);
+        Interval interval[32];
+        size_t interval_count = 0;
+        for (int i = 0; i + 1 < seeds_count; i += 2) {
+            Interval inter = {.from = seeds[i], .to = seeds[i] + seeds[i + 1] - 1};
+            interval[interval_count++] = inter;
         }
-        // check if this is contained in one the given seed intervals
-        for (size_t i = 0; i < interval_count; i++) {
-            if (Interval_contains(&interval[i], seed)) {
-                part2 = location;
-                break;
+
+        // reverse search: location to seed
+        for (i64 location = 1; part2 == 0; location++) {
+            i64 seed = location;
+            for (int j = optimal_path_index_count - 1; j >= 0; j--) {
+                Recipe *r = &inv_recipes[optimal_path_index[j]];
+                seed = Recipe_lookup(r, seed);
+            }
+            // check if this is contained in one the given seed intervals
+            for (size_t i = 0; i < interval_count; i++) {
+                if (Interval_contains(&interval[i], seed)) {
+                    part2 = location;
+                    break;
+                }
             }
         }
     }
@@ -180,12 +187,11 @@ void solve(char *buf, size_t buf_size, Solution *result) {
 }
 
 int solve_input(const char *fname, Solution *result) {
-    char buf[1 << 14];
-    int n = aoc_io_read_input(fname, buf, sizeof(buf));
-    if (n <= 0) {
+    _cleanup_(aoc_io_unmap_input) AocInput input;
+    if (aoc_io_map_input(fname, &input)) {
         fprintf(stderr, "Failed to read %s\n", fname);
         return -1;
     }
-    solve(buf, n, result);
+    solve(input.buf, input.size, result);
     return 0;
 }
@@ -12,7 +12,7 @@
 
 #define N 32
 
-static void extract_digits(i32 number, i64 out[], i32 *out_count) {
+static void extract_digits(i64 number, i64 out[], i32 *out_count) {
     i32 idx = *out_count, tmp[32], tmp_idx = 0;
     while (number != 0) {
         tmp[tmp_idx++] = number % 10;
@@ -41,54 +41,57 @@ static inline i64 count_values(i64 time_avail, i64 record) {
 }
 
 void solve(char *buf, size_t _unused_ buf_size, Solution *result) {
-    i32 time[N], record_dist[N];
+    i64 time[N], record_dist[N];
     int n = 0;
 
     { // parser
+        TIME_PHASE(result, parse);
         size_t pos = 0;
         aoc_parse_seek(buf, &pos, ':');
         pos++;
 
-        i64 tmp;
-        while ((tmp = aoc_parse_nonnegative(buf, &pos)) >= 0) { time[n++] = tmp; }
+        n = aoc_parse_integers(buf, &pos, time, N);
         aoc_parse_seek(buf, &pos, ':');
         pos++;
-        for (int i = 0; i < n; i++) { record_dist[i] = aoc_parse_nonnegative(buf, &pos); }
+        aoc_parse_integers(buf, &pos, record_dist, n);
     }
 
     i64 part1 = 1, part2 = 1;
-    // part 1
-    for (int i = 0; i < n; i++) {
-        i32 time_avail = time[i], record = record_dist[i];
-        i64 count = count_values(time_avail, record);
-        if (count > 0) part1 *= count;
+    { // part 1
+        TIME_PHASE(result, part1);
+        for (int i = 0; i < n; i++) {
+            i64 time_avail = time[i], record = record_dist[i];
+            i64 count = count_values(time_avail, record);
+            if (count > 0) part1 *= count;
+        }
     }
 
-    // part 2
-    i64 time_digits[16], record_digits[16];
-    int time_digits_count = 0, record_digits_count = 0;
-    for (int i = 0; i < n; i++) { extract_digits(time[i], time_digits, &time_digits_count); }
+    { // part 2
+        TIME_PHASE(result, part2);
+        i64 time_digits[16], record_digits[16];
+        int time_digits_count = 0, record_digits_count = 0;
+        for (int i = 0; i < n; i++) { extract_digits(time[i], time_digits, &time_digits_count); }
 
-    for (int i = 0; i < n; i++) { extract_digits(record_dist[i], record_digits, &record_digits_count); }
+        for (int i = 0; i < n; i++) { extract_digits(record_dist[i], record_digits, &record_digits_count); }
 
-    i64 time_avail = 0, record = 0;
-    for (int i = 0; i < time_digits_count; i++) { time_avail = (time_avail * 10) + time_digits[i]; }
-    for (int i = 0; i < record_digits_count; i++) { record = (record * 10) + record_digits[i]; }
+        i64 time_avail = 0, record = 0;
+        for (int i = 0; i < time_digits_count; i++) { time_avail = (time_avail * 10) + time_digits[i]; }
+        for (int i = 0; i < record_digits_count; i++) { record = (record * 10) + record_digits[i]; }
 
-    i64 count = count_values(time_avail, record);
-    if (count > 0) part2 *= count;
+        i64 count = count_values(time_avail, record);
+        if (count > 0) part2 *= count;
+    }
 
     aoc_itoa(part1, result->part1, 10);
     aoc_itoa(part2, result->part2, 10);
 }
 
 int solve_input(const char *fname, Solution *result) {
-    char buf[1 << 14];
-    int n = aoc_io_read_input(fname, buf, sizeof(buf));
-    if (n <= 0) {
+    _cleanup_(aoc_io_unmap_input) AocInput input;
+    if (aoc_io_map_input(fname, &input)) {
         fprintf(stderr, "Failed to read %s\n", fname);
         return -1;
     }
-    solve(buf, n, result);
+    solve(input.buf, input.size, result);
     return 0;
 }
@@ -42,7 +42,7 @@ static inline int break_tie_part2(Hand x, Hand y) {
 
 hand_strength Hand_compute_strength_part2(Hand h) {
     // all possible values a Joker can take on
-    static char joker_values[] = {'A', 'K', 'Q', 'T', '9', '8', '7', '6', '5', '4', '3', '2'};
+    static const char joker_values[] = {'A', 'K', 'Q', 'T', '9', '8', '7', '6', '5', '4', '3', '2'};
 
     int joker_idx[CARDS_PER_HAND];
     int joker_count = 0;
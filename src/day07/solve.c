@@ -19,26 +19,32 @@ void solve(char *buf, size_t buf_size, Solution *result) {
     Hand hand[1000];
     size_t hand_count = 0;
 
-    // parser
-    while (pos < buf_size) {
-        for (int i = 0; i < CARDS_PER_HAND; i++) { hand[hand_count].cards[i] = buf[pos++]; }
-        hand[hand_count].bid = aoc_parse_nonnegative(buf, &pos);
-        hand_count++;
-        pos++; // newline
+    { // parser
+        TIME_PHASE(result, parse);
+        while (pos < buf_size) {
+            for (int i = 0; i < CARDS_PER_HAND; i++) { hand[hand_count].cards[i] = buf[pos++]; }
+            hand[hand_count].bid = aoc_parse_nonnegative(buf, &pos);
+            hand_count++;
+            pos++; // newline
+        }
     }
 
-    // part 1
-    Hand_tim_sort(hand, hand_count); // weakest hand is first
-    for (size_t i = 0; i < hand_count; i++) {
-        i64 rank = i + 1, bid = hand[i].bid;
-        part1 += rank * bid;
+    { // part 1
+        TIME_PHASE(result, part1);
+        Hand_tim_sort(hand, hand_count); // weakest hand is first
+        for (size_t i = 0; i < hand_count; i++) {
+            i64 rank = i + 1, bid = hand[i].bid;
+            part1 += rank * bid;
+        }
     }
 
-    // part 2
-    Hand_part2_tim_sort(hand, hand_count);
-    for (size_t i = 0; i < hand_count; i++) {
-        i64 rank = i + 1, bid = hand[i].bid;
-        part2 += rank * bid;
+    { // part 2
+        TIME_PHASE(result, part2);
+        Hand_part2_tim_sort(hand, hand_count);
+        for (size_t i = 0; i < hand_count; i++) {
+            i64 rank = i + 1, bid = hand[i].bid;
+            part2 += rank * bid;
+        }
     }
 
     aoc_itoa(part1, result->part1, 10);
@@ -46,12 +52,11 @@ void solve(char *buf, size_t buf_size, Solution *result) {
 }
 
 int solve_input(const char *fname, Solution *result) {
-    char buf[1 << 14];
-    int n = aoc_io_read_input(fname, buf, sizeof(buf));
-    if (n <= 0) {
+    _cleanup_(aoc_io_unmap_input) AocInput input;
+    if (aoc_io_map_input(fname, &input)) {
         fprintf(stderr, "Failed to read %s\n", fname);
         return -1;
     }
-    solve(buf, n, result);
+    solve(input.buf, input.size, result);
     return 0;
 }
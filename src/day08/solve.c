@@ -48,6 +48,7 @@ void solve(char *buf, size_t buf_size, Solution *result) {
     u32 node_count = 0;
 
     { // parser
+        TIME_PHASE(result, parse);
         size_t pos = 0;
         while (buf[pos] != '\n') { instruction[instruction_count++] = buf[pos++]; }
         pos += 2; // two newlines
@@ -76,6 +77,7 @@ void solve(char *buf, size_t buf_size, Solution *result) {
 
     int part1 = 0;
     { // part 1
+        TIME_PHASE(result, part1);
         Node start = {.label = {'A', 'A', 'A'}};
         Node dest = {.label = {'Z', 'Z', 'Z'}};
         u32 dest_idx = Node_to_idx(dest);
@@ -92,33 +94,34 @@ void solve(char *buf, size_t buf_size, Solution *result) {
     }
     aoc_itoa(part1, result->part1, 10);
 
-    // part 2: find cycles, compute lcm
     i64 part2 = 1;
-    for (u32 i = 0; i < node_count; i++) {
-        Node start = nodes[i];
-        if (start.label[2] != 'A') continue;
-        log_debug("checking starting node %.*s", 3, start.label);
-        u32 steps = 0;
-        u32 current = Node_to_idx(start);
-        while (idx_to_Node(current).label[2] != 'Z') {
-            Waypoint wp = node_to_wp[current];
-            char inst = instruction[steps % instruction_count];
-            current = inst == 'L' ? wp.left_idx : wp.right_idx;
-            steps++;
+    { // part 2: find cycles, compute lcm
+        TIME_PHASE(result, part2);
+        for (u32 i = 0; i < node_count; i++) {
+            Node start = nodes[i];
+            if (start.label[2] != 'A') continue;
+            log_debug("checking starting node %.*s", 3, start.label);
+            u32 steps = 0;
+            u32 current = Node_to_idx(start);
+            while (idx_to_Node(current).label[2] != 'Z') {
+                Waypoint wp = node_to_wp[current];
+                char inst = instruction[steps % instruction_count];
+                current = inst == 'L' ? wp.left_idx : wp.right_idx;
+                steps++;
+            }
+            log_debug("steps to first z node: %d", steps);
+            part2 = aoc_lcm(part2, steps);
         }
-        log_debug("steps to first z node: %d", steps);
-        part2 = aoc_lcm(part2, steps);
     }
     snprintf(result->part2, sizeof(result->part2), "%ld", part2);
 }
 
 int solve_input(const char *fname, Solution *result) {
-    char buf[1 << 14];
-    int n = aoc_io_read_input(fname, buf, sizeof(buf));
-    if (n <= 0) {
+    _cleanup_(aoc_io_unmap_input) AocInput input;
+    if (aoc_io_map_input(fname, &input)) {
         fprintf(stderr, "Failed to read %s\n", fname);
         return -1;
     }
-    solve(buf, n, result);
+    solve(input.buf, input.size, result);
     return 0;
 }
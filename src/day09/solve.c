@@ -11,8 +11,8 @@
 
 #define MAX_HISTORY 32
 
-void solve(char *buf, size_t buf_size, Solution *result) {
-    i64 part1 = 0, part2 = 0;
+/* Extrapolates the histories in `buf`, which must end with a newline. */
+static void extrapolate(char *buf, size_t buf_size, i64 *part1, i64 *part2, Solution *result) {
     size_t pos = 0;
 
     const size_t base_idx = 1;
@@ -20,12 +20,11 @@ void solve(char *buf, size_t buf_size, Solution *result) {
         i64 differences[MAX_HISTORY][MAX_HISTORY] = {0};
         size_t history_count = 0;
 
-        i64 tmp;
-        while (aoc_parse_integer(buf, &pos, &tmp)) {
-            differences[0][base_idx + history_count] = tmp;
-            history_count++;
+        { // parser
+            TIME_PHASE(result, parse);
+            history_count = aoc_parse_integers(buf, &pos, &differences[0][base_idx], MAX_HISTORY - base_idx - 1);
+            pos++; // newline
         }
-        pos++; // newline
 
         {
             // compute difference sequences
@@ -55,22 +54,36 @@ void solve(char *buf, size_t buf_size, Solution *result) {
 
             } while (depth != 0);
 
-            part1 += differences[0][base_idx + history_count];
-            part2 += differences[0][base_idx - 1];
+            *part1 += differences[0][base_idx + history_count];
+            *part2 += differences[0][base_idx - 1];
         }
     }
+}
 
+void solve(char *buf, size_t buf_size, Solution *result) {
+    i64 part1 = 0, part2 = 0;
+    extrapolate(buf, buf_size, &part1, &part2, result);
     aoc_itoa(part1, result->part1, 10);
     aoc_itoa(part2, result->part2, 10);
 }
 
+int solve_stream(AocStream *stream, Solution *result) {
+    i64 part1 = 0, part2 = 0;
+    char *chunk;
+    size_t chunk_size;
+    while (aoc_stream_next(stream, &chunk, &chunk_size)) { extrapolate(chunk, chunk_size, &part1, &part2, result); }
+    if (aoc_stream_error(stream)) return -1;
+    aoc_itoa(part1, result->part1, 10);
+    aoc_itoa(part2, result->part2, 10);
+    return 0;
+}
+
 int solve_input(const char *fname, Solution *result) {
-    char buf[1 << 15];
-    int n = aoc_io_read_input(fname, buf, sizeof(buf));
-    if (n <= 0) {
+    _cleanup_(aoc_io_unmap_input) AocInput input;
+    if (aoc_io_map_input(fname, &input)) {
         fprintf(stderr, "Failed to read %s\n", fname);
         return -1;
     }
-    solve(buf, n, result);
+    solve(input.buf, input.size, result);
     return 0;
 }
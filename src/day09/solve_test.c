@@ -8,6 +8,8 @@
 
 #define CTEST_MAIN
 
+#include "aoc/io.h"
+#include "aoc/testing.h"
 #include "ctest.h"
 #include "solve.h"
 
@@ -21,6 +23,16 @@ CTEST(day09, example) {
     ASSERT_STR("2", solution.part2);
 }
 
+CTEST(day09, stream) {
+    const char *buf = "0 3 6 9 12 15\n\
+1 3 6 10 15 21\n\
+10 13 16 21 30 45\n";
+    Solution solution;
+    ASSERT_EQUAL(0, aoc_test_solve_stream(buf, &solution));
+    ASSERT_STR("114", solution.part1);
+    ASSERT_STR("2", solution.part2);
+}
+
 #ifdef HAVE_INPUTS
 CTEST(day09, real) {
     Solution solution;
@@ -33,6 +33,36 @@ LJ...\n";
     ASSERT_STR("8", solution.part1);
 }
 
+CTEST(day10, example3) {
+    const char *buf = "..........\n\
+.S------7.\n\
+.|F----7|.\n\
+.||....||.\n\
+.||....||.\n\
+.|L-7F-J|.\n\
+.|..||..|.\n\
+.L--JL--J.\n\
+..........\n";
+    Solution solution;
+    solve(buf, strlen(buf), &solution);
+    ASSERT_STR("4", solution.part2);
+}
+
+CTEST(day10, start_in_first_row) {
+    // pipes next to the loop which do not connect to it must be ignored
+    const char *buf = "F-S.JL.\n\
+|.|L||-\n\
+|-|F-.|\n\
+|L|.F.J\n\
+|.|.J7.\n\
+|||..F.\n\
+L-J|L..\n";
+    Solution solution;
+    solve(buf, strlen(buf), &solution);
+    ASSERT_STR("8", solution.part1);
+    ASSERT_STR("5", solution.part2);
+}
+
 #ifdef HAVE_INPUTS
 CTEST(day10, real) {
     Solution solution;
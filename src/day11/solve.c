@@ -23,6 +23,7 @@ void solve(char *buf, size_t buf_size, Solution *result) {
     i32 empty_row[MAX_POINTS], empty_col[MAX_POINTS];
 
     { // parser
+        TIME_PHASE(result, parse);
         i32 x = 0, y = 0;
         bool is_empty_row = true;
         while (pos < buf_size) {
@@ -101,12 +102,11 @@ void solve(char *buf, size_t buf_size, Solution *result) {
 }
 
 int solve_input(const char *fname, Solution *result) {
-    char buf[1 << 15];
-    int n = aoc_io_read_input(fname, buf, sizeof(buf));
-    if (n <= 0) {
+    _cleanup_(aoc_io_unmap_input) AocInput input;
+    if (aoc_io_map_input(fname, &input)) {
         fprintf(stderr, "Failed to read %s\n", fname);
         return -1;
     }
-    solve(buf, n, result);
+    solve(input.buf, input.size, result);
     return 0;
 }
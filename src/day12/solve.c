@@ -49,14 +49,14 @@ int CacheItem_equal(CacheItem *lhs, CacheItem *rhs) {
 
 #define P
 #define T CacheItem
-#include <ust.h>
+#include "aoc/fmap.h"
 
-static size_t find_solutions(ust_CacheItem *cache, Slice99 spring, Slice99 size, int group_size) {
+static size_t find_solutions(fmap_CacheItem *cache, Slice99 spring, Slice99 size, int group_size) {
     // check cache for answer
     CacheItem item = {.spring = spring, .size = size, .group_size = group_size};
 
-    ust_CacheItem_node *node = ust_CacheItem_find(cache, item);
-    if (node != NULL) { return node->key.value; }
+    CacheItem *cached = fmap_CacheItem_find(cache, item);
+    if (cached != NULL) { return cached->value; }
 
     if (Slice99_is_empty(spring)) {
         if (size.len == 1 && *(int *)Slice99_first(size) == group_size) { return 1; }
@@ -93,14 +93,16 @@ static size_t find_solutions(ust_CacheItem *cache, Slice99 spring, Slice99 size,
 
     // save item in cache
     item.value = count;
-    ust_CacheItem_insert(cache, item);
+    fmap_CacheItem_insert(cache, item);
 
     return count;
 }
 
-void solve(char *buf, size_t buf_size, Solution *result) {
-    size_t part1 = 0, part2 = 0;
-
+/* Counts the arrangements of the rows in `buf`, which must end with a newline. */
+static void count_arrangements(char *buf, size_t buf_size, size_t *part1, size_t *part2, Solution *result) {
+    // the caches live in an arena: dropping a cache is a reset instead of freeing every node
+    _cleanup_(aoc_arena_destroy) AocArena *arena = aoc_arena_create(0);
+    ARENA_SCOPE(arena);
     for (size_t pos = 0; pos < buf_size;) { // parser
         char spring[MAX_SPRINGS];
         int spring_count = 0;
@@ -108,26 +110,31 @@ void solve(char *buf, size_t buf_size, Solution *result) {
         int size[MAX_GROUPS];
         int size_count = 0;
 
-        while (buf[pos] != ' ') { spring[spring_count++] = buf[pos++]; }
-        pos++;                     // whitespace
-        while (buf[pos] != '\n') { // groups
-            i64 value = aoc_parse_nonnegative(buf, &pos);
-            assert(value > 0);
-            size[size_count++] = value;
-            if (buf[pos] == ',') pos++;
+        { // line
+            TIME_PHASE(result, parse);
+            while (buf[pos] != ' ') { spring[spring_count++] = buf[pos++]; }
+            pos++;                     // whitespace
+            while (buf[pos] != '\n') { // groups
+                i64 value = aoc_parse_nonnegative(buf, &pos);
+                assert(value > 0);
+                size[size_count++] = value;
+                if (buf[pos] == ',') pos++;
+            }
         }
 
         { // part 1
-            ust_CacheItem cache = ust_CacheItem_init(CacheItem_hash, CacheItem_equal);
+            TIME_PHASE(result, part1);
+            fmap_CacheItem cache = fmap_CacheItem_init(CacheItem_hash, CacheItem_equal);
             Slice99 spring_slice = Slice99_from_typed_ptr(spring, spring_count);
             Slice99 size_slice = Slice99_from_typed_ptr(size, size_count);
             size_t count = find_solutions(&cache, spring_slice, size_slice, 0);
-            part1 += count;
-            ust_CacheItem_free(&cache);
+            *part1 += count;
+            aoc_arena_reset(arena);
         }
 
         { // part 2
-            ust_CacheItem cache = ust_CacheItem_init(CacheItem_hash, CacheItem_equal);
+            TIME_PHASE(result, part2);
+            fmap_CacheItem cache = fmap_CacheItem_init(CacheItem_hash, CacheItem_equal);
             char big_spring[MAX_SPRINGS];
             int big_spring_count = 0;
             for (int i = 1; i <= 5; i++) {
@@ -146,25 +153,40 @@ void solve(char *buf, size_t buf_size, Solution *result) {
             Slice99 big_spring_slice = Slice99_from_typed_ptr(big_spring, big_spring_count);
             Slice99 big_size_slice = Slice99_from_typed_ptr(big_size, big_size_count);
             size_t count = find_solutions(&cache, big_spring_slice, big_size_slice, 0);
-            part2 += count;
-
-            ust_CacheItem_free(&cache);
+            *part2 += count;
+            aoc_arena_reset(arena);
         }
 
         pos++;
     }
+}
 
+void solve(char *buf, size_t buf_size, Solution *result) {
+    size_t part1 = 0, part2 = 0;
+    count_arrangements(buf, buf_size, &part1, &part2, result);
     snprintf(result->part1, sizeof(result->part1), "%ld", part1);
     snprintf(result->part2, sizeof(result->part2), "%ld", part2);
 }
 
+int solve_stream(AocStream *stream, Solution *result) {
+    size_t part1 = 0, part2 = 0;
+    char *chunk;
+    size_t chunk_size;
+    while (aoc_stream_next(stream, &chunk, &chunk_size)) {
+        count_arrangements(chunk, chunk_size, &part1, &part2, result);
+    }
+    if (aoc_stream_error(stream)) return -1;
+    snprintf(result->part1, sizeof(result->part1), "%ld", part1);
+    snprintf(result->part2, sizeof(result->part2), "%ld", part2);
+    return 0;
+}
+
 int solve_input(const char *fname, Solution *result) {
-    char buf[1 << 15];
-    int n = aoc_io_read_input(fname, buf, sizeof(buf));
-    if (n <= 0) {
+    _cleanup_(aoc_io_unmap_input) AocInput input;
+    if (aoc_io_map_input(fname, &input)) {
         fprintf(stderr, "Failed to read %s\n", fname);
         return -1;
     }
-    solve(buf, n, result);
+    solve(input.buf, input.size, result);
     return 0;
 }
@@ -8,6 +8,8 @@
 
 #define CTEST_MAIN
 
+#include "aoc/io.h"
+#include "aoc/testing.h"
 #include "ctest.h"
 #include "solve.h"
 
@@ -24,6 +26,19 @@ CTEST(day12, example) {
     ASSERT_STR("525152", solution.part2);
 }
 
+CTEST(day12, stream) {
+    const char *buf = "???.### 1,1,3\n\
+.??..??...?##. 1,1,3\n\
+?#?#?#?#?#?#?#? 1,3,1,6\n\
+????.#...#... 4,1,1\n\
+????.######..#####. 1,6,5\n\
+?###???????? 3,2,1\n";
+    Solution solution;
+    ASSERT_EQUAL(0, aoc_test_solve_stream(buf, &solution));
+    ASSERT_STR("21", solution.part1);
+    ASSERT_STR("525152", solution.part2);
+}
+
 #ifdef HAVE_INPUTS
 CTEST(day12, real) {
     Solution solution;
@@ -67,16 +67,19 @@ void solve(char *buf, size_t buf_size, Solution *result) {
 
     while (pos < buf_size) {
         grid_t grid = {0};
-        while (1) {
-            int x = 0;
-            while (buf[pos] != '\n') { grid.data[grid.rows][x++] = buf[pos++]; }
-            grid.rows++;
-            grid.cols = x;
-            pos++; // newline
-            if (pos >= buf_size || buf[pos] == '\n') {
-                // current pattern is over
-                pos++;
-                break;
+        { // pattern
+            TIME_PHASE(result, parse);
+            while (1) {
+                int x = 0;
+                while (buf[pos] != '\n') { grid.data[grid.rows][x++] = buf[pos++]; }
+                grid.rows++;
+                grid.cols = x;
+                pos++; // newline
+                if (pos >= buf_size || buf[pos] == '\n') {
+                    // current pattern is over
+                    pos++;
+                    break;
+                }
             }
         }
 
@@ -113,12 +116,11 @@ void solve(char *buf, size_t buf_size, Solution *result) {
 }
 
 int solve_input(const char *fname, Solution *result) {
-    char buf[1 << 15];
-    int n = aoc_io_read_input(fname, buf, sizeof(buf));
-    if (n <= 0) {
+    _cleanup_(aoc_io_unmap_input) AocInput input;
+    if (aoc_io_map_input(fname, &input)) {
         fprintf(stderr, "Failed to read %s\n", fname);
         return -1;
     }
-    solve(buf, n, result);
+    solve(input.buf, input.size, result);
     return 0;
 }
@@ -23,9 +23,7 @@
 #define T XXH128_hash_t
 #include <ust.h>
 
-static char platform[MAX_DIM][MAX_DIM];
-
-static void tilt_north(int rows, int cols) {
+static void tilt_north(char platform[MAX_DIM][MAX_DIM], int rows, int cols) {
     for (int y = 1; y < rows; y++) {
         for (int x = 0; x < cols; x++) {
             char c = platform[y][x];
@@ -41,7 +39,7 @@ static void tilt_north(int rows, int cols) {
     }
 }
 
-static void tilt_south(int rows, int cols) {
+static void tilt_south(char platform[MAX_DIM][MAX_DIM], int rows, int cols) {
     for (int y = rows - 2; y >= 0; y--) {
         for (int x = 0; x < cols; x++) {
             char c = platform[y][x];
@@ -57,7 +55,7 @@ static void tilt_south(int rows, int cols) {
     }
 }
 
-static void tilt_east(int rows, int cols) {
+static void tilt_east(char platform[MAX_DIM][MAX_DIM], int rows, int cols) {
     for (int x = cols - 2; x >= 0; x--) {
         for (int y = 0; y < rows; y++) {
             char c = platform[y][x];
@@ -73,7 +71,7 @@ static void tilt_east(int rows, int cols) {
     }
 }
 
-static void tilt_west(int rows, int cols) {
+static void tilt_west(char platform[MAX_DIM][MAX_DIM], int rows, int cols) {
     for (int x = 1; x < cols; x++) {
         for (int y = 0; y < rows; y++) {
             char c = platform[y][x];
@@ -89,7 +87,7 @@ static void tilt_west(int rows, int cols) {
     }
 }
 
-static i64 compute_total_load(int rows, int cols) {
+static i64 compute_total_load(char platform[MAX_DIM][MAX_DIM], int rows, int cols) {
     i64 result = 0;
     for (int y = 0; y < rows; y++) {
         for (int x = 0; x < cols; x++) {
@@ -111,9 +109,11 @@ static size_t hash(XXH128_hash_t *x) {
 static int equal(XXH128_hash_t *a, XXH128_hash_t *b) { return a->low64 == b->low64 && a->high64 == b->high64; }
 
 void solve(char *buf, size_t buf_size, Solution *result) {
+    char platform[MAX_DIM][MAX_DIM] = {0};
     size_t pos = 0;
     int rows, cols = 0;
     { // parser
+        TIME_PHASE(result, parse);
         int y = 0, x = 0;
         while (pos < buf_size) {
             char c = buf[pos];
@@ -130,68 +130,74 @@ void solve(char *buf, size_t buf_size, Solution *result) {
 
     i64 part1, part2 = 0;
 
-    XXH128_hash_t hashes[MAX_CYCLE_LEN] = {0};
-    int hashes_count = 0;
-    _cleanup_(ust_XXH128_hash_t_free) ust_XXH128_hash_t seen = ust_XXH128_hash_t_init(hash, equal);
-    ust_XXH128_hash_t_reserve(&seen, MAX_CYCLE_LEN);
-
-    XXH128_hash_t duplicate;
-
-    // find cycle
-    int cycle = 0;
-    for (; cycle < MAX_CYCLE_LEN; cycle++) {
-        tilt_north(rows, cols);
-        if (cycle == 0) { part1 = compute_total_load(rows, cols); }
-
-        tilt_west(rows, cols);
-        tilt_south(rows, cols);
-        tilt_east(rows, cols);
-
-        XXH128_hash_t value = XXH3_128bits(&platform[0][0], rows * cols);
-        hashes[hashes_count++] = value;
+    { // part 1
+        TIME_PHASE(result, part1);
+        tilt_north(platform, rows, cols);
+        part1 = compute_total_load(platform, rows, cols);
+    }
 
-        ust_XXH128_hash_t_node *node = ust_XXH128_hash_t_find(&seen, value);
-        if (node != NULL) {
-            duplicate = value;
-            break;
-        } else {
-            ust_XXH128_hash_t_insert(&seen, value);
+    { // part 2
+        TIME_PHASE(result, part2);
+        XXH128_hash_t hashes[MAX_CYCLE_LEN] = {0};
+        int hashes_count = 0;
+        _cleanup_(ust_XXH128_hash_t_free) ust_XXH128_hash_t seen = ust_XXH128_hash_t_init(hash, equal);
+        ust_XXH128_hash_t_reserve(&seen, MAX_CYCLE_LEN);
+
+        XXH128_hash_t duplicate;
+
+        // find cycle
+        int cycle = 0;
+        for (; cycle < MAX_CYCLE_LEN; cycle++) {
+            tilt_north(platform, rows, cols);
+            tilt_west(platform, rows, cols);
+            tilt_south(platform, rows, cols);
+            tilt_east(platform, rows, cols);
+
+            XXH128_hash_t value = XXH3_128bits(&platform[0][0], rows * cols);
+            hashes[hashes_count++] = value;
+
+            ust_XXH128_hash_t_node *node = ust_XXH128_hash_t_find(&seen, value);
+            if (node != NULL) {
+                duplicate = value;
+                break;
+            } else {
+                ust_XXH128_hash_t_insert(&seen, value);
+            }
         }
-    }
 
-    int cycle_start = 0;
-    while (!equal(&hashes[cycle_start], &duplicate)) { cycle_start++; }
-    int cycle_len = 1;
-    while (!equal(&hashes[cycle_start + cycle_len], &duplicate)) { cycle_len++; }
-    log_debug("cycle starts at %d and has length %d", cycle_start, cycle_len);
-    // we are at the begining of the cycle
-    log_debug("we are at cycle %d", cycle);
-
-    int last_cycle = 1000000000 - 1;
-
-    int delta = last_cycle - cycle;
-    log_debug("%d cycles left to compute", delta);
-
-    int rem = last_cycle % delta; // shortcut
-    for (int i = 0; i <= rem; i++) {
-        tilt_north(rows, cols);
-        tilt_west(rows, cols);
-        tilt_south(rows, cols);
-        tilt_east(rows, cols);
+        int cycle_start = 0;
+        while (!equal(&hashes[cycle_start], &duplicate)) { cycle_start++; }
+        int cycle_len = 1;
+        while (!equal(&hashes[cycle_start + cycle_len], &duplicate)) { cycle_len++; }
+        log_debug("cycle starts at %d and has length %d", cycle_start, cycle_len);
+        // we are at the begining of the cycle
+        log_debug("we are at cycle %d", cycle);
+
+        int last_cycle = 1000000000 - 1;
+
+        int delta = last_cycle - cycle;
+        log_debug("%d cycles left to compute", delta);
+
+        int rem = last_cycle % delta; // shortcut
+        for (int i = 0; i <= rem; i++) {
+            tilt_north(platform, rows, cols);
+            tilt_west(platform, rows, cols);
+            tilt_south(platform, rows, cols);
+            tilt_east(platform, rows, cols);
+        }
+        part2 = compute_total_load(platform, rows, cols);
     }
-    part2 = compute_total_load(rows, cols);
 
     snprintf(result->part1, sizeof(result->part1), "%ld", part1);
     snprintf(result->part2, sizeof(result->part2), "%ld", part2);
 }
 
 int solve_input(const char *fname, Solution *result) {
-    char buf[1 << 14];
-    int n = aoc_io_read_input(fname, buf, sizeof(buf));
-    if (n <= 0) {
+    _cleanup_(aoc_io_unmap_input) AocInput input;
+    if (aoc_io_map_input(fname, &input)) {
         fprintf(stderr, "Failed to read %s\n", fname);
         return -1;
     }
-    solve(buf, n, result);
+    solve(input.buf, input.size, result);
     return 0;
 }
@@ -20,8 +20,6 @@ typedef struct {
     direction_t direction;
 } beam_t;
 
-static char grid[MAX_GRID_SIZE][MAX_GRID_SIZE];
-
 static inline void advance_beam(beam_t *beam) {
     switch (beam->direction) {
     case NORTH: beam->y--; break;
@@ -41,7 +39,7 @@ static inline char pretty_direction(direction_t d) {
     }
 }
 
-static int run_simulation(beam_t start, int rows, int cols) {
+static int run_simulation(char grid[MAX_GRID_SIZE][MAX_GRID_SIZE], beam_t start, int rows, int cols) {
     // each entry is a bitset containing the directions of the beam which visited it
     int visited[MAX_GRID_SIZE][MAX_GRID_SIZE];
     memset(visited, 0, sizeof(visited));
@@ -114,19 +112,23 @@ static int run_simulation(beam_t start, int rows, int cols) {
 }
 
 void solve(char *buf, size_t buf_size, Solution *result) {
+    char grid[MAX_GRID_SIZE][MAX_GRID_SIZE];
     int rows = 0, cols = 0;
 
-    size_t pos = 0;
-    int x = 0;
-    while (pos < buf_size) {
-        char c = buf[pos++];
-        if (c == '\n') {
-            cols = x;
-            x = 0;
-            rows++;
-            continue;
+    { // parser
+        TIME_PHASE(result, parse);
+        size_t pos = 0;
+        int x = 0;
+        while (pos < buf_size) {
+            char c = buf[pos++];
+            if (c == '\n') {
+                cols = x;
+                x = 0;
+                rows++;
+                continue;
+            }
+            grid[rows][x++] = c;
         }
-        grid[rows][x++] = c;
     }
     log_debug("rows: %d, cols: %d", rows, cols);
 
@@ -137,7 +139,7 @@ void solve(char *buf, size_t buf_size, Solution *result) {
         if (direction != NORTH) {
             for (int x = 0; x < cols; x++) {
                 beam_t start = (beam_t){.x = x, .y = 0, .direction = direction};
-                int value = run_simulation(start, rows, cols);
+                int value = run_simulation(grid, start, rows, cols);
                 if (direction == EAST && x == 0) part1 = value;
                 part2 = MAX(part2, value);
             }
@@ -146,7 +148,7 @@ void solve(char *buf, size_t buf_size, Solution *result) {
         if (direction != SOUTH) {
             for (int x = 0; x < cols; x++) {
                 beam_t start = (beam_t){.x = x, .y = rows - 1, .direction = direction};
-                int value = run_simulation(start, rows, cols);
+                int value = run_simulation(grid, start, rows, cols);
                 part2 = MAX(part2, value);
             }
         }
@@ -154,7 +156,7 @@ void solve(char *buf, size_t buf_size, Solution *result) {
         if (direction != WEST) {
             for (int y = 0; y < rows; y++) {
                 beam_t start = (beam_t){.x = 0, .y = y, .direction = direction};
-                int value = run_simulation(start, rows, cols);
+                int value = run_simulation(grid, start, rows, cols);
                 part2 = MAX(part2, value);
             }
         }
@@ -162,7 +164,7 @@ void solve(char *buf, size_t buf_size, Solution *result) {
         if (direction != EAST) {
             for (int y = 0; y < rows; y++) {
                 beam_t start = (beam_t){.x = cols - 1, .y = y, .direction = direction};
-                int value = run_simulation(start, rows, cols);
+                int value = run_simulation(grid, start, rows, cols);
                 part2 = MAX(part2, value);
             }
         }
@@ -173,12 +175,11 @@ void solve(char *buf, size_t buf_size, Solution *result) {
 }
 
 int solve_input(const char *fname, Solution *result) {
-    char buf[1 << 14];
-    int n = aoc_io_read_input(fname, buf, sizeof(buf));
-    if (n <= 0) {
+    _cleanup_(aoc_io_unmap_input) AocInput input;
+    if (aoc_io_map_input(fname, &input)) {
         fprintf(stderr, "Failed to read %s\n", fname);
         return -1;
     }
-    solve(buf, n, result);
+    solve(input.buf, input.size, result);
     return 0;
 }
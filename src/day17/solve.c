@@ -36,7 +36,7 @@ typedef struct {
 
 #define P
 #define T NodeDistance
-#include <ust.h>
+#include "aoc/fmap.h"
 
 // min queue
 static int State_compare(State *lhs, State *rhs) { return lhs->dist < rhs->dist; }
@@ -184,15 +184,18 @@ void solve(char *buf, size_t buf_size, Solution *result) {
     int grid[GRID_SIZE][GRID_SIZE];
     int rows = 0, cols = 0;
 
-    for (int pos = 0, x = 0; pos < (int)buf_size; pos++) {
-        char c = buf[pos];
-        switch (c) {
-        case '\n':
-            cols = x;
-            x = 0;
-            rows++;
-            break;
-        default: grid[rows][x++] = c - '0'; break;
+    { // parser
+        TIME_PHASE(result, parse);
+        for (int pos = 0, x = 0; pos < (int)buf_size; pos++) {
+            char c = buf[pos];
+            switch (c) {
+            case '\n':
+                cols = x;
+                x = 0;
+                rows++;
+                break;
+            default: grid[rows][x++] = c - '0'; break;
+            }
         }
     }
 
@@ -200,16 +203,21 @@ void solve(char *buf, size_t buf_size, Solution *result) {
     Node start_node_1 = {.position = start, .direction = EAST, .direction_count = 0};
     Node start_node_2 = {.position = start, .direction = SOUTH, .direction_count = 0};
 
+    // the queue and distance map of each part are released in one go by resetting the arena
+    _cleanup_(aoc_arena_destroy) AocArena *arena = aoc_arena_create(0);
+
     // Dijkstra part 1
     {
+        TIME_PHASE(result, part1);
+        ARENA_SCOPE(arena);
         _cleanup_(pqu_State_free) pqu_State queue = pqu_State_init(State_compare);
         pqu_State_push(&queue, (State){.node = start_node_1, .dist = 0});
         pqu_State_push(&queue, (State){.node = start_node_2, .dist = 0});
 
-        _cleanup_(ust_NodeDistance_free) ust_NodeDistance distances =
-            ust_NodeDistance_init(NodeDistance_hash, NodeDistance_equal);
-        ust_NodeDistance_insert(&distances, (NodeDistance){.node = start_node_1, .distance = 0});
-        ust_NodeDistance_insert(&distances, (NodeDistance){.node = start_node_2, .distance = 0});
+        _cleanup_(fmap_NodeDistance_free) fmap_NodeDistance distances =
+            fmap_NodeDistance_init(NodeDistance_hash, NodeDistance_equal);
+        fmap_NodeDistance_insert(&distances, (NodeDistance){.node = start_node_1, .distance = 0});
+        fmap_NodeDistance_insert(&distances, (NodeDistance){.node = start_node_2, .distance = 0});
 
         // dijkstra
         while (!pqu_State_empty(&queue)) {
@@ -227,9 +235,14 @@ void solve(char *buf, size_t buf_size, Solution *result) {
                 Node nb = neighbor[i];
                 int alt = current.dist + grid[nb.position.y][nb.position.x];
                 NodeDistance node_distance = {.node = nb, .distance = alt};
-                ust_NodeDistance_node *entry = ust_NodeDistance_find(&distances, node_distance);
-                if (entry != NULL && entry->key.distance <= alt) { continue; }
-                ust_NodeDistance_insert(&distances, node_distance);
+                NodeDistance *entry = fmap_NodeDistance_find(&distances, node_distance);
+                if (entry == NULL) {
+                    fmap_NodeDistance_insert(&distances, node_distance);
+                } else if (entry->distance <= alt) {
+                    continue;
+                } else {
+                    entry->distance = alt;
+                }
                 pqu_State_push(&queue, (State){.node = nb, .dist = alt});
             }
         }
@@ -237,14 +250,17 @@ void solve(char *buf, size_t buf_size, Solution *result) {
 
     // Dijkstra part 2
     {
+        TIME_PHASE(result, part2);
+        aoc_arena_reset(arena);
+        ARENA_SCOPE(arena);
         _cleanup_(pqu_State_free) pqu_State queue = pqu_State_init(State_compare);
         pqu_State_push(&queue, (State){.node = start_node_1, .dist = 0});
         pqu_State_push(&queue, (State){.node = start_node_2, .dist = 0});
 
-        _cleanup_(ust_NodeDistance_free) ust_NodeDistance distances =
-            ust_NodeDistance_init(NodeDistance_hash, NodeDistance_equal);
-        ust_NodeDistance_insert(&distances, (NodeDistance){.node = start_node_1, .distance = 0});
-        ust_NodeDistance_insert(&distances, (NodeDistance){.node = start_node_2, .distance = 0});
+        _cleanup_(fmap_NodeDistance_free) fmap_NodeDistance distances =
+            fmap_NodeDistance_init(NodeDistance_hash, NodeDistance_equal);
+        fmap_NodeDistance_insert(&distances, (NodeDistance){.node = start_node_1, .distance = 0});
+        fmap_NodeDistance_insert(&distances, (NodeDistance){.node = start_node_2, .distance = 0});
 
         // dijkstra
         while (!pqu_State_empty(&queue)) {
@@ -267,19 +283,20 @@ void solve(char *buf, size_t buf_size, Solution *result) {
                 log_debug("checking neighbor %d,%d", nb.position.y, nb.position.x);
                 int alt = current.dist + grid[nb.position.y][nb.position.x];
                 NodeDistance node_distance = {.node = nb, .distance = alt};
-                ust_NodeDistance_node *entry = ust_NodeDistance_find(&distances, node_distance);
+                NodeDistance *entry = fmap_NodeDistance_find(&distances, node_distance);
                 if (entry != NULL) {
-                    if (entry->key.distance <= alt) {
+                    if (entry->distance <= alt) {
                         log_debug("discarding y,x %d,%d: current best %d is better than %d", nb.position.y,
-                                  nb.position.x, entry->key.distance, alt);
+                                  nb.position.x, entry->distance, alt);
                         continue;
                     }
+                    entry->distance = alt;
                 } else {
                     log_debug("entry %d,%d not found in map", node_distance.node.position.y,
                               node_distance.node.position.x);
+                    fmap_NodeDistance_insert(&distances, node_distance);
                 }
-                log_debug("inserting new best dist for y,x %d,%d: %d", nb.position.y, nb.position.x, alt);
-                ust_NodeDistance_insert(&distances, node_distance);
+                log_debug("new best dist for y,x %d,%d: %d", nb.position.y, nb.position.x, alt);
                 pqu_State_push(&queue, (State){.node = nb, .dist = alt});
             }
         }
@@ -290,12 +307,11 @@ void solve(char *buf, size_t buf_size, Solution *result) {
 }
 
 int solve_input(const char *fname, Solution *result) {
-    char buf[1 << 15];
-    int n = aoc_io_read_input(fname, buf, sizeof(buf));
-    if (n <= 0) {
+    _cleanup_(aoc_io_unmap_input) AocInput input;
+    if (aoc_io_map_input(fname, &input)) {
         fprintf(stderr, "Failed to read %s\n", fname);
         return -1;
     }
-    solve(buf, n, result);
+    solve(input.buf, input.size, result);
     return 0;
 }
@@ -40,8 +40,8 @@ static inline i64 calc_area(data_t *data) {
     return (data->area + data->boundary) / 2 + 1;
 }
 
-void solve(char *buf, size_t buf_size, Solution *result) {
-    data_t p1 = {.boundary = 1}, p2 = {.boundary = 1};
+/* Follows the dig plan in `buf`, which must end with a newline. */
+static void dig(char *buf, size_t buf_size, data_t *p1, data_t *p2) {
     for (size_t pos = 0; pos < buf_size;) {
         char p1_direction = buf[pos++];
         pos++;
@@ -63,24 +63,43 @@ void solve(char *buf, size_t buf_size, Solution *result) {
         aoc_parse_seek(buf, &pos, '\n');
         pos++;
 
-        update_data(&p1, p1_direction, p1_steps);
-        update_data(&p2, p2_direction, p2_steps);
+        update_data(p1, p1_direction, p1_steps);
+        update_data(p2, p2_direction, p2_steps);
     }
+}
+
+void solve(char *buf, size_t buf_size, Solution *result) {
+    data_t p1 = {.boundary = 1}, p2 = {.boundary = 1};
+    dig(buf, buf_size, &p1, &p2);
+
+    i64 part1 = calc_area(&p1);
+    i64 part2 = calc_area(&p2);
+
+    snprintf(result->part1, sizeof(result->part1), "%ld", part1);
+    snprintf(result->part2, sizeof(result->part2), "%ld", part2);
+}
+
+int solve_stream(AocStream *stream, Solution *result) {
+    data_t p1 = {.boundary = 1}, p2 = {.boundary = 1};
+    char *chunk;
+    size_t chunk_size;
+    while (aoc_stream_next(stream, &chunk, &chunk_size)) { dig(chunk, chunk_size, &p1, &p2); }
+    if (aoc_stream_error(stream)) return -1;
 
     i64 part1 = calc_area(&p1);
     i64 part2 = calc_area(&p2);
 
     snprintf(result->part1, sizeof(result->part1), "%ld", part1);
     snprintf(result->part2, sizeof(result->part2), "%ld", part2);
+    return 0;
 }
 
 int solve_input(const char *fname, Solution *result) {
-    char buf[1 << 14];
-    int n = aoc_io_read_input(fname, buf, sizeof(buf));
-    if (n <= 0) {
+    _cleanup_(aoc_io_unmap_input) AocInput input;
+    if (aoc_io_map_input(fname, &input)) {
         fprintf(stderr, "Failed to read %s\n", fname);
         return -1;
     }
-    solve(buf, n, result);
+    solve(input.buf, input.size, result);
     return 0;
 }
@@ -8,6 +8,8 @@
 
 #define CTEST_MAIN
 
+#include "aoc/io.h"
+#include "aoc/testing.h"
 #include "ctest.h"
 #include "solve.h"
 
@@ -32,6 +34,27 @@ U 2 (#7a21e3)\n";
     ASSERT_STR("952408144115", solution.part2);
 }
 
+CTEST(day18, stream) {
+    const char *buf = "R 6 (#70c710)\n\
+D 5 (#0dc571)\n\
+L 2 (#5713f0)\n\
+D 2 (#d2c081)\n\
+R 2 (#59c680)\n\
+D 2 (#411b91)\n\
+L 5 (#8ceee2)\n\
+U 2 (#caa173)\n\
+L 1 (#1b58a2)\n\
+U 2 (#caa171)\n\
+R 2 (#7807d2)\n\
+U 3 (#a77fa3)\n\
+L 2 (#015232)\n\
+U 2 (#7a21e3)\n";
+    Solution solution;
+    ASSERT_EQUAL(0, aoc_test_solve_stream(buf, &solution));
+    ASSERT_STR("62", solution.part1);
+    ASSERT_STR("952408144115", solution.part2);
+}
+
 #ifdef HAVE_INPUTS
 CTEST(day18, real) {
     Solution solution;
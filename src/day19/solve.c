@@ -39,7 +39,7 @@ typedef struct {
 
 #define P
 #define T workflow_t
-#include <ust.h>
+#include "aoc/fmap.h"
 
 typedef struct {
     int lower, upper; // inclusive
@@ -131,113 +131,120 @@ void solve(char *buf, size_t buf_size, Solution *result) {
     int part1 = 0;
     size_t pos = 0;
 
-    _cleanup_(ust_workflow_t_free) ust_workflow_t workflows = ust_workflow_t_init(workflow_t_hash, workflow_t_equal);
-    ust_workflow_t_reserve(&workflows, 256);
+    _cleanup_(aoc_arena_destroy) AocArena *arena = aoc_arena_create(0);
+    ARENA_SCOPE(arena);
+    _cleanup_(fmap_workflow_t_free) fmap_workflow_t workflows = fmap_workflow_t_init(workflow_t_hash, workflow_t_equal);
+    fmap_workflow_t_reserve(&workflows, 256);
 
-    while (1) {
-        workflow_t wf = {.rule_count = 0};
+    { // parser
+        TIME_PHASE(result, parse);
+        while (1) {
+            workflow_t wf = {.rule_count = 0};
 
-        size_t start = pos;
-        while (buf[pos] != '{') pos++;
-        wf.name = CharSlice99_new(&buf[start], pos - start);
+            size_t start = pos;
+            while (buf[pos] != '{') pos++;
+            wf.name = CharSlice99_new(&buf[start], pos - start);
 
-        pos++;
+            pos++;
 
-        // next are the rules
-        while (1) {
-            char op = buf[pos + 1]; // look ahead
-            rule_t *rule = &wf.rule[wf.rule_count];
-            if (op == '<' || op == '>') {
-                rule->kind = op == '<' ? LT : GT;
-                rule->variable = buf[pos];
-                pos += 2;
-                rule->value = aoc_parse_nonnegative(buf, &pos);
-                pos++;
-                size_t start = pos;
-                while (buf[pos] != ',') pos++;
-                rule->destination = CharSlice99_new(&buf[start], pos - start);
-                pos++;
-                wf.rule_count++;
-            } else { // this is the last rule, a jump
-                rule->kind = JUMP;
-                size_t start = pos;
-                while (buf[pos] != '}') pos++;
-                rule->destination = CharSlice99_new(&buf[start], pos - start);
-                wf.rule_count++;
-                break;
+            // next are the rules
+            while (1) {
+                char op = buf[pos + 1]; // look ahead
+                rule_t *rule = &wf.rule[wf.rule_count];
+                if (op == '<' || op == '>') {
+                    rule->kind = op == '<' ? LT : GT;
+                    rule->variable = buf[pos];
+                    pos += 2;
+                    rule->value = aoc_parse_nonnegative(buf, &pos);
+                    pos++;
+                    size_t start = pos;
+                    while (buf[pos] != ',') pos++;
+                    rule->destination = CharSlice99_new(&buf[start], pos - start);
+                    pos++;
+                    wf.rule_count++;
+                } else { // this is the last rule, a jump
+                    rule->kind = JUMP;
+                    size_t start = pos;
+                    while (buf[pos] != '}') pos++;
+                    rule->destination = CharSlice99_new(&buf[start], pos - start);
+                    wf.rule_count++;
+                    break;
+                }
             }
-        }
 
-        log_debug(">> workflow %.*s has %d rules", wf.name.len, wf.name.ptr, wf.rule_count);
-        ust_workflow_t_insert(&workflows, wf);
+            log_debug(">> workflow %.*s has %d rules", wf.name.len, wf.name.ptr, wf.rule_count);
+            fmap_workflow_t_insert(&workflows, wf);
 
-        aoc_parse_seek(buf, &pos, '\n');
-        pos++;
-        if (buf[pos] == '\n') break; // workflows finished, inputs are next
+            aoc_parse_seek(buf, &pos, '\n');
+            pos++;
+            if (buf[pos] == '\n') break; // workflows finished, inputs are next
+        }
     }
 
     CharSlice99 start = CharSlice99_from_str("in");
-    ust_workflow_t_node *start_node = ust_workflow_t_find(&workflows, (workflow_t){.name = start});
+    workflow_t *start_workflow = fmap_workflow_t_find(&workflows, (workflow_t){.name = start});
     CharSlice99 accepted = CharSlice99_from_str("A"), rejected = CharSlice99_from_str("R");
 
-    // part 1
-    pos++;
-    while (pos < buf_size) {
-        if (buf[pos++] == '{') {
-            data_t data = {0};
-            while (pos < buf_size) {
-                char var = buf[pos];
-                pos += 2;
-                int value = aoc_parse_nonnegative(buf, &pos);
-                switch (var) {
-                case 'x': data.x = value; break;
-                case 'm': data.m = value; break;
-                case 'a': data.a = value; break;
-                case 's': data.s = value; break;
+    { // part 1
+        TIME_PHASE(result, part1);
+        pos++;
+        while (pos < buf_size) {
+            if (buf[pos++] == '{') {
+                data_t data = {0};
+                while (pos < buf_size) {
+                    char var = buf[pos];
+                    pos += 2;
+                    int value = aoc_parse_nonnegative(buf, &pos);
+                    switch (var) {
+                    case 'x': data.x = value; break;
+                    case 'm': data.m = value; break;
+                    case 'a': data.a = value; break;
+                    case 's': data.s = value; break;
+                    }
+                    if (buf[pos] == '}') break;
+                    pos++;
                 }
-                if (buf[pos] == '}') break;
-                pos++;
-            }
-            workflow_t *current = &start_node->key;
-            while (1) {
-                CharSlice99 *next = workflow_next(current, data);
-                assert(next != NULL);
-                if (CharSlice99_primitive_eq(*next, accepted)) {
-                    part1 += data.x + data.a + data.m + data.s;
-                    break;
-                } else if (CharSlice99_primitive_eq(*next, rejected)) {
-                    break;
+                workflow_t *current = start_workflow;
+                while (1) {
+                    CharSlice99 *next = workflow_next(current, data);
+                    assert(next != NULL);
+                    if (CharSlice99_primitive_eq(*next, accepted)) {
+                        part1 += data.x + data.a + data.m + data.s;
+                        break;
+                    } else if (CharSlice99_primitive_eq(*next, rejected)) {
+                        break;
+                    }
+                    current = fmap_workflow_t_find(&workflows, (workflow_t){.name = *next});
                 }
-                current = &ust_workflow_t_find(&workflows, (workflow_t){.name = *next})->key;
             }
         }
     }
 
-    // part 2
     i64 part2 = 0;
-
-    state_t stack[4096];
-    interval_t initial = {.lower = LOWER, .upper = UPPER};
-    stack[0] = (state_t){.src = start,
-                         .constraint = (constraint_t){.x = initial, .m = initial, .a = initial, .s = initial},
-                         .rule_idx = 0};
-    int stack_size = 1;
-    while (stack_size != 0) {
-        state_t state = stack[--stack_size]; // pop
-        if (CharSlice99_primitive_eq(state.src, accepted)) {
-            part2 += constraint_cardinality(state.constraint);
-        } else if (CharSlice99_primitive_eq(state.src, rejected)) {
-            continue;
-        } else {
-            ust_workflow_t_node *node = ust_workflow_t_find(&workflows, (workflow_t){.name = state.src});
-            assert(node != NULL);
-            workflow_t *wf = &node->key;
-            rule_t *rule = &wf->rule[state.rule_idx];
-            constraint_t yes = constraint_apply_rule(state.constraint, rule);
-            constraint_t no = constraint_negate_rule(state.constraint, rule);
-            stack[stack_size++] = (state_t){.src = rule->destination, .rule_idx = 0, .constraint = yes};
-            if (rule->kind != JUMP) {
-                stack[stack_size++] = (state_t){.src = state.src, .rule_idx = state.rule_idx + 1, .constraint = no};
+    { // part 2
+        TIME_PHASE(result, part2);
+        state_t stack[4096];
+        interval_t initial = {.lower = LOWER, .upper = UPPER};
+        stack[0] = (state_t){.src = start,
+                             .constraint = (constraint_t){.x = initial, .m = initial, .a = initial, .s = initial},
+                             .rule_idx = 0};
+        int stack_size = 1;
+        while (stack_size != 0) {
+            state_t state = stack[--stack_size]; // pop
+            if (CharSlice99_primitive_eq(state.src, accepted)) {
+                part2 += constraint_cardinality(state.constraint);
+            } else if (CharSlice99_primitive_eq(state.src, rejected)) {
+                continue;
+            } else {
+                workflow_t *wf = fmap_workflow_t_find(&workflows, (workflow_t){.name = state.src});
+                assert(wf != NULL);
+                rule_t *rule = &wf->rule[state.rule_idx];
+                constraint_t yes = constraint_apply_rule(state.constraint, rule);
+                constraint_t no = constraint_negate_rule(state.constraint, rule);
+                stack[stack_size++] = (state_t){.src = rule->destination, .rule_idx = 0, .constraint = yes};
+                if (rule->kind != JUMP) {
+                    stack[stack_size++] = (state_t){.src = state.src, .rule_idx = state.rule_idx + 1, .constraint = no};
+                }
             }
         }
     }
@@ -247,12 +254,11 @@ void solve(char *buf, size_t buf_size, Solution *result) {
 }
 
 int solve_input(const char *fname, Solution *result) {
-    char buf[1 << 15];
-    int n = aoc_io_read_input(fname, buf, sizeof(buf));
-    if (n <= 0) {
+    _cleanup_(aoc_io_unmap_input) AocInput input;
+    if (aoc_io_map_input(fname, &input)) {
         fprintf(stderr, "Failed to read %s\n", fname);
         return -1;
     }
-    solve(buf, n, result);
+    solve(input.buf, input.size, result);
     return 0;
 }
@@ -45,7 +45,7 @@ typedef struct {
 
 #define P
 #define T module_t
-#include <ust.h>
+#include "aoc/fmap.h"
 
 typedef struct {
     CharSlice99 source, destination;
@@ -65,9 +65,12 @@ typedef struct {
     bool watches_send_high[4];
 } push_result_t;
 
-static push_result_t push_button(ust_module_t *modules, CharSlice99 *watches, int watches_count) {
+/* `scratch` is reset on every call and backs the pulse queue. */
+static push_result_t push_button(AocArena *scratch, fmap_module_t *modules, CharSlice99 *watches, int watches_count) {
     push_result_t result = {.low_count = 0, .high_count = 0};
 
+    aoc_arena_reset(scratch);
+    ARENA_SCOPE(scratch);
     _cleanup_(que_state_t_free) que_state_t queue = que_state_t_init();
     que_state_t_push(&queue, (state_t){.source = CharSlice99_from_str("button"),
                                        .destination = CharSlice99_from_str("broadcaster"),
@@ -88,9 +91,8 @@ static push_result_t push_button(ust_module_t *modules, CharSlice99 *watches, in
             }
         }
 
-        ust_module_t_node *node = ust_module_t_find(modules, (module_t){.name = current->destination});
-        if (node) {
-            module_t *m = &node->key;
+        module_t *m = fmap_module_t_find(modules, (module_t){.name = current->destination});
+        if (m) {
             switch (m->kind) {
             case BROADCAST:
                 for (int i = 0; i < m->output_count; i++) {
@@ -149,10 +151,10 @@ static push_result_t push_button(ust_module_t *modules, CharSlice99 *watches, in
     return result;
 }
 
-static void reset_modules(ust_module_t *modules) {
+static void reset_modules(fmap_module_t *modules) {
     log_debug("resetting modules");
-    foreach (ust_module_t, modules, it) {
-        module_t *m = &it.node->key;
+    foreach (fmap_module_t, modules, it) {
+        module_t *m = it.ref;
         if (m->kind == FLIP_FLOP) {
             m->state.on = false;
         } else if (m->kind == CONJUNCTION) {
@@ -164,58 +166,60 @@ static void reset_modules(ust_module_t *modules) {
 void solve(char *buf, size_t buf_size, Solution *result) {
     i64 part1 = 0, part2 = 0;
 
-    _cleanup_(ust_module_t_free) ust_module_t modules = ust_module_t_init(module_t_hash, module_t_equal);
+    _cleanup_(fmap_module_t_free) fmap_module_t modules = fmap_module_t_init(module_t_hash, module_t_equal);
+    _cleanup_(aoc_arena_destroy) AocArena *scratch = aoc_arena_create(0);
 
     size_t pos = 0;
-    while (pos < buf_size) {
-        char c = buf[pos];
-
-        module_t m = {.kind = BROADCAST, .output_count = 0};
-        if (c == '%') {
-            m.kind = FLIP_FLOP;
-            m.state.on = false;
-            pos++;
-        } else if (c == '&') {
-            m.kind = CONJUNCTION;
-            pos++;
-        }
-        int len = 0;
-        while (buf[pos + len] != ' ') { len++; }
-        m.name = CharSlice99_new(&buf[pos], len);
-        pos += len;
-        log_debug(">> module name: %.*s", m.name.len, m.name.ptr);
-
-        aoc_parse_seek(buf, &pos, '>');
-        pos += 2;
-
-        while (1) {
-            len = 0;
-            while (buf[pos + len] != ',' && buf[pos + len] != '\n') { len++; }
-            m.output[m.output_count++] = CharSlice99_new(&buf[pos], len);
+    { // parser
+        TIME_PHASE(result, parse);
+        while (pos < buf_size) {
+            char c = buf[pos];
+
+            module_t m = {.kind = BROADCAST, .output_count = 0};
+            if (c == '%') {
+                m.kind = FLIP_FLOP;
+                m.state.on = false;
+                pos++;
+            } else if (c == '&') {
+                m.kind = CONJUNCTION;
+                pos++;
+            }
+            int len = 0;
+            while (buf[pos + len] != ' ') { len++; }
+            m.name = CharSlice99_new(&buf[pos], len);
             pos += len;
-            if (buf[pos] == '\n') { break; }
-            pos += 2; // skip comma
-        }
-        for (int i = 0; i < m.output_count; i++) { log_debug("\toutput: %.*s", m.output[i].len, m.output[i].ptr); }
+            log_debug(">> module name: %.*s", m.name.len, m.name.ptr);
+
+            aoc_parse_seek(buf, &pos, '>');
+            pos += 2;
+
+            while (1) {
+                size_t start = pos;
+                aoc_parse_seek_any(buf, &pos, ",\n");
+                m.output[m.output_count++] = CharSlice99_new(&buf[start], pos - start);
+                if (buf[pos] == '\n') { break; }
+                pos += 2; // skip comma
+            }
+            for (int i = 0; i < m.output_count; i++) { log_debug("\toutput: %.*s", m.output[i].len, m.output[i].ptr); }
 
-        aoc_parse_seek(buf, &pos, '\n');
-        pos++;
+            aoc_parse_seek(buf, &pos, '\n');
+            pos++;
 
-        ust_module_t_insert(&modules, m);
+            fmap_module_t_insert(&modules, m);
+        }
     }
 
     // initialize conjunction items with their incoming signals to low
     CharSlice99 rx_source = {.len = 0};
-    foreach (ust_module_t, &modules, it) {
-        module_t *m = &it.node->key;
+    foreach (fmap_module_t, &modules, it) {
+        module_t *m = it.ref;
         CharSlice99 source = m->name;
         for (int i = 0; i < m->output_count; i++) {
             CharSlice99 destination = m->output[i];
             if (CharSlice99_primitive_eq(destination, CharSlice99_from_str("rx"))) { rx_source = source; }
 
-            ust_module_t_node *node = ust_module_t_find(&modules, (module_t){.name = destination});
-            if (node == NULL) continue;
-            module_t *dest_module = &node->key;
+            module_t *dest_module = fmap_module_t_find(&modules, (module_t){.name = destination});
+            if (dest_module == NULL) continue;
             if (dest_module->kind == CONJUNCTION) {
                 bool found = false;
                 for (int j = 0; j < dest_module->state.list.len; j++) {
@@ -235,45 +239,51 @@ void solve(char *buf, size_t buf_size, Solution *result) {
         }
     }
 
-    int low_count = 0, high_count = 0;
-    for (int round = 1; round <= 1000; round++) {
-        push_result_t hl = push_button(&modules, NULL, 0);
-        low_count += hl.low_count, high_count += hl.high_count;
+    { // part 1
+        TIME_PHASE(result, part1);
+        int low_count = 0, high_count = 0;
+        for (int round = 1; round <= 1000; round++) {
+            push_result_t hl = push_button(scratch, &modules, NULL, 0);
+            low_count += hl.low_count, high_count += hl.high_count;
+        }
+        part1 = high_count * low_count;
     }
-    part1 = high_count * low_count;
 
-    reset_modules(&modules);
-
-    /*
-     * 1. &lg -> rx has to send a low pulse
-     * 2. So everything (4 modules) going into lg must send a high pulse.
-     * 3. For each of the 4 modules, check how many button presses it takes to send a high pulse to lg.
-     * 4. The answer is the lcm of these button presses.
-     */
-    if (rx_source.len > 0) {
-        log_debug("rx source: %.*s", rx_source.len, rx_source.ptr); // this is the conjunction lg
-        module_t rx_source_module = ust_module_t_find(&modules, (module_t){.name = rx_source})->key;
-        assert(rx_source_module.kind == CONJUNCTION);
+    { // part 2
+        TIME_PHASE(result, part2);
+        reset_modules(&modules);
+
+        /*
+         * 1. &lg -> rx has to send a low pulse
+         * 2. So everything (4 modules) going into lg must send a high pulse.
+         * 3. For each of the 4 modules, check how many button presses it takes to send a high pulse to lg.
+         * 4. The answer is the lcm of these button presses.
+         */
+        if (rx_source.len > 0) {
+            log_debug("rx source: %.*s", rx_source.len, rx_source.ptr); // this is the conjunction lg
+            module_t rx_source_module = *fmap_module_t_find(&modules, (module_t){.name = rx_source});
+            assert(rx_source_module.kind == CONJUNCTION);
 
 #define MAX_WATCHES 4
-        CharSlice99 watches[MAX_WATCHES];
-        int watches_count = 0;
-        for (int i = 0; i < rx_source_module.state.list.len; i++) {
-            watches[watches_count++] = rx_source_module.state.list.items[i].name;
-        }
-        for (int i = 0; i < watches_count; i++) { log_debug("watching: %.*s", watches[i].len, watches[i].ptr); }
-
-        i64 button_presses[MAX_WATCHES] = {0, 0, 0, 0};
-        for (int count = 1; count <= 5000; count++) { // empirically this is enough
-            push_result_t result = push_button(&modules, watches, watches_count);
-            for (int i = 0; i < watches_count; i++) {
-                if (button_presses[i] == 0 && result.watches_send_high[i]) {
-                    log_debug("%.*s sends high pulse after %d presses", watches[i].len, watches[i].ptr, count);
-                    button_presses[i] = count;
+            CharSlice99 watches[MAX_WATCHES];
+            int watches_count = 0;
+            for (int i = 0; i < rx_source_module.state.list.len; i++) {
+                watches[watches_count++] = rx_source_module.state.list.items[i].name;
+            }
+            for (int i = 0; i < watches_count; i++) { log_debug("watching: %.*s", watches[i].len, watches[i].ptr); }
+
+            i64 button_presses[MAX_WATCHES] = {0, 0, 0, 0};
+            for (int count = 1; count <= 5000; count++) { // empirically this is enough
+                push_result_t result = push_button(scratch, &modules, watches, watches_count);
+                for (int i = 0; i < watches_count; i++) {
+                    if (button_presses[i] == 0 && result.watches_send_high[i]) {
+                        log_debug("%.*s sends high pulse after %d presses", watches[i].len, watches[i].ptr, count);
+                        button_presses[i] = count;
+                    }
                 }
+                part2 = button_presses[0] * button_presses[1] * button_presses[2] * button_presses[3]; // coprime
+                if (part2 != 0) break;
             }
-            part2 = button_presses[0] * button_presses[1] * button_presses[2] * button_presses[3]; // coprime
-            if (part2 != 0) break;
         }
     }
 
@@ -282,12 +292,11 @@ void solve(char *buf, size_t buf_size, Solution *result) {
 }
 
 int solve_input(const char *fname, Solution *result) {
-    char buf[1 << 14];
-    int n = aoc_io_read_input(fname, buf, sizeof(buf));
-    if (n <= 0) {
+    _cleanup_(aoc_io_unmap_input) AocInput input;
+    if (aoc_io_map_input(fname, &input)) {
         fprintf(stderr, "Failed to read %s\n", fname);
         return -1;
     }
-    solve(buf, n, result);
+    solve(input.buf, input.size, result);
     return 0;
 }
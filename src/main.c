@@ -5,16 +5,54 @@
  *
  * SPDX-License-Identifier: Apache-2.0
  */
+#include <getopt.h>
 #include <stdio.h>
+#include <stdlib.h>
 
+#include "batch/batch.h"
 #include "solve.h"
 
 #ifndef DAY
 #error "Please define DAY"
 #endif
 
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [INPUT]\n"
+            "       %s --batch DIR|LIST|- [--jobs N]\n"
+            "\n"
+            "Solves INPUT (default: input/" DAY ".txt).\n"
+            "\n"
+            "Options:\n"
+            "  -b, --batch DIR|LIST|-   solve all files in DIR, or all files listed in LIST\n"
+            "                           (one per line, '-' for stdin), in parallel\n"
+            "  -j, --jobs N             number of threads for --batch (default: one per CPU)\n"
+            "  -h, --help               show this help\n",
+            prog, prog);
+}
+
 int main(int argc, char *argv[]) {
-    const char *fname = argc > 1 ? argv[1] : "input/" DAY ".txt";
+    const char *batch = NULL;
+    int jobs = 0;
+
+    static const struct option options[] = {
+        {"batch", required_argument, NULL, 'b'},
+        {"jobs", required_argument, NULL, 'j'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0},
+    };
+    int opt;
+    while ((opt = getopt_long(argc, argv, "b:j:h", options, NULL)) != -1) {
+        switch (opt) {
+        case 'b': batch = optarg; break;
+        case 'j': jobs = atoi(optarg); break;
+        case 'h': usage(argv[0]); return 0;
+        default: usage(argv[0]); return 1;
+        }
+    }
+    if (batch != NULL) return aoc_batch_run(batch, jobs, solve) ? 1 : 0;
+
+    const char *fname = optind < argc ? argv[optind] : "input/" DAY ".txt";
     Solution solution;
     if (solve_input(fname, &solution)) {
         fprintf(stderr, DAY ": no solution found!\n");
@@ -0,0 +1,195 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Just enough of a JSON parser for the reports of `bench --json`: strings
+ * without unicode escapes, numbers, literals, objects and arrays.
+ */
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "aoc/io.h"
+#include "aoc/macros.h"
+#include "baseline.h"
+
+typedef struct {
+    const char *p;
+    const char *end;
+} Json;
+
+static void skip_ws(Json *json) {
+    while (json->p < json->end && isspace((unsigned char)*json->p)) json->p++;
+}
+
+static bool accept(Json *json, char c) {
+    skip_ws(json);
+    if (json->p < json->end && *json->p == c) {
+        json->p++;
+        return true;
+    }
+    return false;
+}
+
+/* Reads a string into `out` (truncated to `out_size`). */
+static bool parse_string(Json *json, char *out, size_t out_size) {
+    if (!accept(json, '"')) return false;
+    size_t len = 0;
+    while (json->p < json->end && *json->p != '"') {
+        if (*json->p == '\\' && json->p + 1 < json->end) json->p++;
+        if (len + 1 < out_size) out[len++] = *json->p;
+        json->p++;
+    }
+    if (out_size > 0) out[len] = '\0';
+    return accept(json, '"');
+}
+
+static bool parse_number(Json *json, double *out) {
+    skip_ws(json);
+    char *end;
+    *out = strtod(json->p, &end);
+    if (end == json->p || end > json->end) return false;
+    json->p = end;
+    return true;
+}
+
+static bool parse_bool(Json *json, int *out) {
+    skip_ws(json);
+    size_t left = json->end - json->p;
+    if (left >= 4 && strncmp(json->p, "true", 4) == 0) {
+        json->p += 4;
+        *out = 1;
+        return true;
+    }
+    if (left >= 5 && strncmp(json->p, "false", 5) == 0) {
+        json->p += 5;
+        *out = 0;
+        return true;
+    }
+    return false;
+}
+
+static bool skip_value(Json *json) {
+    skip_ws(json);
+    if (json->p >= json->end) return false;
+    char c = *json->p;
+    if (c == '"') return parse_string(json, NULL, 0);
+    if (c == '{' || c == '[') {
+        char close = c == '{' ? '}' : ']';
+        json->p++;
+        if (accept(json, close)) return true;
+        do {
+            if (c == '{' && !(parse_string(json, NULL, 0) && accept(json, ':'))) return false;
+            if (!skip_value(json)) return false;
+        } while (accept(json, ','));
+        return accept(json, close);
+    }
+    if (isalpha((unsigned char)c)) { // true, false, null
+        while (json->p < json->end && isalpha((unsigned char)*json->p)) json->p++;
+        return true;
+    }
+    double ignored;
+    return parse_number(json, &ignored);
+}
+
+/* Parses the object of one day; the median is mandatory. */
+static bool parse_day(Json *json, AocBaselineEntry *entry) {
+    if (!accept(json, '{')) return false;
+    bool has_median = false;
+    if (accept(json, '}')) return false;
+    do {
+        char key[32];
+        double value;
+        if (!parse_string(json, key, sizeof(key)) || !accept(json, ':')) return false;
+        if (strcmp(key, "median_ns") == 0) {
+            if (!parse_number(json, &value)) return false;
+            entry->median_ns = value;
+            has_median = true;
+        } else if (strcmp(key, "input_bytes") == 0) {
+            if (!parse_number(json, &value)) return false;
+            entry->input_bytes = value;
+        } else if (strcmp(key, "tolerance") == 0) {
+            if (!parse_number(json, &entry->tolerance)) return false;
+        } else if (!skip_value(json)) {
+            return false;
+        }
+    } while (accept(json, ','));
+    return accept(json, '}') && has_median;
+}
+
+static bool parse_days(Json *json, AocBaseline *baseline, size_t capacity) {
+    if (!accept(json, '{')) return false;
+    if (accept(json, '}')) return true;
+    do {
+        if (baseline->count == capacity) return false;
+        AocBaselineEntry *entry = &baseline->entries[baseline->count];
+        *entry = (AocBaselineEntry){.tolerance = -1};
+        if (!parse_string(json, entry->day, sizeof(entry->day)) || !accept(json, ':') || !parse_day(json, entry)) {
+            return false;
+        }
+        baseline->count++;
+    } while (accept(json, ','));
+    return accept(json, '}');
+}
+
+static bool parse_baseline(Json *json, AocBaseline *baseline, double *tolerance, size_t capacity) {
+    if (!accept(json, '{')) return false;
+    if (accept(json, '}')) return true;
+    do {
+        char key[32];
+        if (!parse_string(json, key, sizeof(key)) || !accept(json, ':')) return false;
+        bool ok = strcmp(key, "days") == 0        ? parse_days(json, baseline, capacity)
+                  : strcmp(key, "tolerance") == 0 ? parse_number(json, tolerance)
+                  : strcmp(key, "cpu") == 0       ? parse_string(json, baseline->cpu, sizeof(baseline->cpu))
+                  : strcmp(key, "isa") == 0       ? parse_string(json, baseline->isa, sizeof(baseline->isa))
+                  : strcmp(key, "ndebug") == 0    ? parse_bool(json, &baseline->ndebug)
+                                                  : skip_value(json);
+        if (!ok) return false;
+    } while (accept(json, ','));
+    return accept(json, '}');
+}
+
+int aoc_baseline_load(const char *path, double default_tolerance, AocBaseline *baseline) {
+    *baseline = (AocBaseline){.ndebug = -1};
+    _cleanup_(aoc_io_unmap_input) AocInput input;
+    if (aoc_io_map_input(path, &input)) {
+        fprintf(stderr, "baseline: failed to read %s\n", path);
+        return -1;
+    }
+
+    // every day takes more than 16 bytes
+    size_t capacity = input.size / 16 + 1;
+    baseline->entries = calloc(capacity, sizeof(AocBaselineEntry));
+    if (baseline->entries == NULL) abort();
+    Json json = {.p = input.buf, .end = input.buf + input.size};
+    double tolerance = default_tolerance;
+    if (!parse_baseline(&json, baseline, &tolerance, capacity)) {
+        fprintf(stderr, "baseline: %s: invalid JSON near offset %zu\n", path, (size_t)(json.p - input.buf));
+        aoc_baseline_free(baseline);
+        return -2;
+    }
+    for (size_t i = 0; i < baseline->count; i++) {
+        if (baseline->entries[i].tolerance < 0) baseline->entries[i].tolerance = tolerance;
+    }
+    return 0;
+}
+
+void aoc_baseline_free(AocBaseline *baseline) {
+    free(baseline->entries);
+    *baseline = (AocBaseline){0};
+}
+
+const AocBaselineEntry *aoc_baseline_find(const AocBaseline *baseline, const char *day) {
+    for (size_t i = 0; i < baseline->count; i++) {
+        if (strcmp(baseline->entries[i].day, day) == 0) return &baseline->entries[i];
+    }
+    return NULL;
+}
@@ -0,0 +1,62 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#include "aoc/types.h"
+
+/* The expected median of a day and how much slower it may get. */
+typedef struct {
+    char day[16];
+    u64 median_ns;
+    u64 input_bytes;  /* size of the input measured, 0 if unknown */
+    double tolerance; /* e.g. 0.2 for +20% */
+} AocBaselineEntry;
+
+/**
+ * Stored benchmark results to compare against (see `bench --baseline`).
+ *
+ * A baseline is a JSON file in the format of `bench --json`, of which only
+ * the "cpu", "isa", "ndebug" and the per-day "median_ns" and "input_bytes"
+ * are used. A "tolerance" (a fraction) at the top level or in a day's object
+ * overrides the default tolerance:
+ *
+ *     {
+ *       "tolerance": 0.2,
+ *       "days": {
+ *         "day01": { "median_ns": 276000 },
+ *         "day05": { "median_ns": 1400000000, "tolerance": 0.1 }
+ *       }
+ *     }
+ */
+typedef struct {
+    char cpu[256]; /* model of the CPU measured on, empty if unknown */
+    char isa[16];  /* instruction set level of the parser kernels, empty if unknown */
+    int ndebug;    /* whether assertions were compiled out: 1, 0 or -1 if unknown */
+    AocBaselineEntry *entries;
+    size_t count;
+} AocBaseline;
+
+/**
+ * Loads the baseline `path`; days without a tolerance get `default_tolerance`.
+ *
+ * @return 0 on success, a negative value on error (reported to stderr).
+ */
+int aoc_baseline_load(const char *path, double default_tolerance, AocBaseline *baseline);
+
+/**
+ * Releases the baseline. Suitable for use with _cleanup_().
+ */
+void aoc_baseline_free(AocBaseline *baseline);
+
+/**
+ * @return The entry of `day` or NULL if the baseline has none.
+ */
+const AocBaselineEntry *aoc_baseline_find(const AocBaseline *baseline, const char *day);
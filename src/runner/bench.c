@@ -0,0 +1,339 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Benchmark harness.
+ *
+ * Every selected day's input is loaded once, then solve() is called `warmup`
+ * times without measuring followed by `iterations` measured calls. The
+ * results are summarized as min/median/p99/max and can be written as a JSON
+ * report so runs can be compared across compilers and machines.
+ *
+ * With --baseline, the medians are compared with a stored report and the
+ * exit status is non-zero if any day got slower than its tolerance allows,
+ * unless the report was measured on another CPU.
+ */
+
+#include <getopt.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "aoc/cpu.h"
+#include "aoc/io.h"
+#include "aoc/macros.h"
+#include "aoc/time.h"
+#include "baseline.h"
+#include "days.h"
+#include "runner.h"
+#include "stats.h"
+
+#define MAX_DAYS 64
+
+typedef struct {
+    const AocDay *day;
+    char input[256];
+    size_t input_size;
+    Solution solution;
+    AocStats stats;
+#ifdef AOC_TIMING
+    SolveTiming timing; // mean over the measured runs
+#endif
+} BenchResult;
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [OPTIONS] [DAY...]\n"
+            "\n"
+            "Benchmarks the given days (or all days) on pre-loaded inputs.\n"
+            "\n"
+            "Options:\n"
+            "  -w, --warmup N       unmeasured runs before measuring (default: 3)\n"
+            "  -n, --iterations N   measured runs per day (default: 50)\n"
+            "  -o, --json FILE      write a JSON report to FILE ('-' for stdout)\n"
+            "  -c, --cpu N          pin the benchmark to CPU N\n"
+            "  -i, --inputs DIR     read the inputs from DIR/dayXX.txt (default: input)\n"
+            "  -B, --baseline FILE  compare the medians with those of FILE (a JSON report) and\n"
+            "                       fail if a day is slower than the tolerance allows (only\n"
+            "                       warn if FILE was measured on another CPU, skip it if by\n"
+            "                       another build)\n"
+            "  -t, --tolerance PCT  default tolerance for --baseline in percent (default: 20)\n"
+            "  -h, --help           show this help\n",
+            prog);
+}
+
+static int bench_day(const AocDay *day, const char *input_dir, int warmup, int iterations, BenchResult *result) {
+    result->day = day;
+    aoc_day_input_path(day, input_dir, result->input, sizeof(result->input));
+
+    AocInput input;
+    if (aoc_io_map_input(result->input, &input)) {
+        fprintf(stderr, "%s: failed to read %s\n", day->name, result->input);
+        return -1;
+    }
+    result->input_size = input.size;
+
+    for (int i = 0; i < warmup; i++) { day->solve(input.buf, input.size, &result->solution); }
+
+#ifdef AOC_TIMING
+    result->timing = (SolveTiming){0};
+#endif
+    u64 *samples = malloc(iterations * sizeof(u64));
+    if (samples == NULL) {
+        fprintf(stderr, "%s: out of memory\n", day->name);
+        abort();
+    }
+    for (int i = 0; i < iterations; i++) {
+        result->solution = (Solution){0};
+        u64 start = aoc_time_now_ns();
+        day->solve(input.buf, input.size, &result->solution);
+        samples[i] = aoc_time_now_ns() - start;
+#ifdef AOC_TIMING
+        result->timing.parse_ns += result->solution.timing.parse_ns;
+        result->timing.part1_ns += result->solution.timing.part1_ns;
+        result->timing.part2_ns += result->solution.timing.part2_ns;
+#endif
+    }
+    aoc_stats_compute(samples, iterations, &result->stats);
+#ifdef AOC_TIMING
+    result->timing.parse_ns /= iterations;
+    result->timing.part1_ns /= iterations;
+    result->timing.part2_ns /= iterations;
+#endif
+
+    free(samples);
+    aoc_io_unmap_input(&input);
+    return 0;
+}
+
+static void print_duration(FILE *f, u64 ns) {
+    char s[32];
+    aoc_format_duration(ns, s, sizeof(s));
+    // 'µ' takes two bytes but only one column
+    fprintf(f, " %*s", strstr(s, "µ") ? 13 : 12, s);
+}
+
+static void print_table(const BenchResult results[], size_t count) {
+    printf("%-6s %12s %12s %12s %12s\n", "day", "min", "median", "p99", "max");
+    for (size_t i = 0; i < count; i++) {
+        const AocStats *s = &results[i].stats;
+        printf("%-6s", results[i].day->name);
+        print_duration(stdout, s->min);
+        print_duration(stdout, s->median);
+        print_duration(stdout, s->p99);
+        print_duration(stdout, s->max);
+        printf("\n");
+    }
+}
+
+static void read_cpu_model(char *out, size_t out_size) {
+    snprintf(out, out_size, "unknown");
+    FILE *f = fopen("/proc/cpuinfo", "r");
+    if (!f) return;
+    char line[512];
+    while (fgets(line, sizeof(line), f)) {
+        if (strncmp(line, "model name", 10) != 0) continue;
+        char *value = strchr(line, ':');
+        if (value == NULL) break;
+        value += 2;
+        value[strcspn(value, "\n")] = '\0';
+        snprintf(out, out_size, "%s", value);
+        break;
+    }
+    fclose(f);
+}
+
+#ifdef NDEBUG
+#define BENCH_NDEBUG 1
+#else
+#define BENCH_NDEBUG 0
+#endif
+
+/*
+ * Prints the medians next to the baseline's and returns the number of days
+ * which regressed. A baseline of another build (assertions or kernels) is
+ * skipped, as are days measured on a different input, and if the baseline
+ * was measured on a different CPU, regressions are only reported.
+ */
+static int compare_baseline(FILE *f, const BenchResult results[], size_t count, const AocBaseline *baseline) {
+    const char *isa = aoc_cpu_isa_name(aoc_cpu_isa());
+    if (baseline->ndebug >= 0 && baseline->ndebug != BENCH_NDEBUG) {
+        fprintf(f, "\nbaseline skipped: it was measured %s assertions, this build has them %s\n",
+                baseline->ndebug ? "without" : "with", BENCH_NDEBUG ? "compiled out" : "enabled");
+        return 0;
+    }
+    if (baseline->isa[0] != '\0' && strcmp(baseline->isa, isa) != 0) {
+        fprintf(f, "\nbaseline skipped: it was measured with the %s kernels, this run uses %s\n", baseline->isa, isa);
+        return 0;
+    }
+    char cpu[256];
+    read_cpu_model(cpu, sizeof(cpu));
+    bool same_cpu = baseline->cpu[0] == '\0' || strcmp(baseline->cpu, cpu) == 0;
+    if (!same_cpu) {
+        fprintf(f, "\nwarning: the baseline was measured on %s, not on %s; regressions do not fail\n", baseline->cpu,
+                cpu);
+    }
+    fprintf(f, "\n%-6s %12s %12s %8s %9s\n", "day", "baseline", "median", "change", "tolerance");
+    int regressions = 0;
+    for (size_t i = 0; i < count; i++) {
+        const char *name = results[i].day->name;
+        u64 median = results[i].stats.median;
+        const AocBaselineEntry *entry = aoc_baseline_find(baseline, name);
+        fprintf(f, "%-6s", name);
+        if (entry == NULL || (entry->input_bytes != 0 && entry->input_bytes != results[i].input_size)) {
+            fprintf(f, " %12s", "-");
+            print_duration(f, median);
+            fprintf(f, "  (%s)\n", entry == NULL ? "not in the baseline" : "baseline measured on another input");
+            continue;
+        }
+        double change = (double)median / MAX(entry->median_ns, (u64)1) - 1;
+        bool regressed = change > entry->tolerance;
+        regressions += regressed;
+        print_duration(f, entry->median_ns);
+        print_duration(f, median);
+        fprintf(f, " %+7.1f%% %8.0f%%%s\n", 100 * change, 100 * entry->tolerance, regressed ? "  REGRESSION" : "");
+    }
+    if (regressions) fprintf(f, "%d of %zu days regressed\n", regressions, count);
+    return same_cpu ? regressions : 0;
+}
+
+static void json_string(FILE *f, const char *s) {
+    fputc('"', f);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') fputc('\\', f);
+        fputc(*s, f);
+    }
+    fputc('"', f);
+}
+
+static void write_json(FILE *f, const BenchResult results[], size_t count, int warmup, int iterations) {
+    char cpu[256], timestamp[32];
+    read_cpu_model(cpu, sizeof(cpu));
+    time_t now = time(NULL);
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+    fprintf(f, "{\n");
+    fprintf(f, "  \"timestamp\": \"%s\",\n", timestamp);
+    fprintf(f, "  \"cpu\": ");
+    json_string(f, cpu);
+#ifdef __clang__
+    fprintf(f, ",\n  \"compiler\": \"clang " __clang_version__ "\",\n");
+#else
+    fprintf(f, ",\n  \"compiler\": \"gcc " __VERSION__ "\",\n");
+#endif
+    fprintf(f, "  \"ndebug\": %s,\n", BENCH_NDEBUG ? "true" : "false");
+    fprintf(f, "  \"isa\": \"%s\",\n", aoc_cpu_isa_name(aoc_cpu_isa()));
+    fprintf(f, "  \"warmup\": %d,\n", warmup);
+    fprintf(f, "  \"iterations\": %d,\n", iterations);
+    fprintf(f, "  \"days\": {\n");
+    for (size_t i = 0; i < count; i++) {
+        const BenchResult *r = &results[i];
+        const AocStats *s = &r->stats;
+        fprintf(f, "    \"%s\": {\n", r->day->name);
+        fprintf(f, "      \"input\": ");
+        json_string(f, r->input);
+        fprintf(f, ",\n      \"input_bytes\": %zu,\n", r->input_size);
+        fprintf(f, "      \"part1\": ");
+        json_string(f, r->solution.part1);
+        fprintf(f, ",\n      \"part2\": ");
+        json_string(f, r->solution.part2);
+        fprintf(f, ",\n");
+        fprintf(f, "      \"min_ns\": %lu,\n", s->min);
+        fprintf(f, "      \"median_ns\": %lu,\n", s->median);
+        fprintf(f, "      \"p99_ns\": %lu,\n", s->p99);
+        fprintf(f, "      \"max_ns\": %lu,\n", s->max);
+        fprintf(f, "      \"mean_ns\": %lu,\n", s->mean);
+#ifdef AOC_TIMING
+        fprintf(f, "      \"parse_ns\": %lu,\n", r->timing.parse_ns);
+        fprintf(f, "      \"part1_ns\": %lu,\n", r->timing.part1_ns);
+        fprintf(f, "      \"part2_ns\": %lu,\n", r->timing.part2_ns);
+#endif
+        fprintf(f, "      \"stddev_ns\": %.1f\n", s->stddev);
+        fprintf(f, "    }%s\n", i + 1 < count ? "," : "");
+    }
+    fprintf(f, "  }\n}\n");
+}
+
+int main(int argc, char *argv[]) {
+    int warmup = 3, iterations = 50, cpu = -1;
+    const char *json_path = NULL, *input_dir = NULL, *baseline_path = NULL;
+    double tolerance = 0.2;
+
+    static const struct option options[] = {
+        {"warmup", required_argument, NULL, 'w'}, {"iterations", required_argument, NULL, 'n'},
+        {"json", required_argument, NULL, 'o'},   {"cpu", required_argument, NULL, 'c'},
+        {"inputs", required_argument, NULL, 'i'}, {"baseline", required_argument, NULL, 'B'},
+        {"tolerance", required_argument, NULL, 't'}, {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0},
+    };
+    int opt;
+    while ((opt = getopt_long(argc, argv, "w:n:o:c:i:B:t:h", options, NULL)) != -1) {
+        switch (opt) {
+        case 'w': warmup = atoi(optarg); break;
+        case 'n': iterations = atoi(optarg); break;
+        case 'o': json_path = optarg; break;
+        case 'c': cpu = atoi(optarg); break;
+        case 'i': input_dir = optarg; break;
+        case 'B': baseline_path = optarg; break;
+        case 't': tolerance = atof(optarg) / 100; break;
+        case 'h': usage(argv[0]); return 0;
+        default: usage(argv[0]); return 1;
+        }
+    }
+    if (warmup < 0 || iterations <= 0) {
+        fprintf(stderr, "invalid warmup or iteration count\n");
+        return 1;
+    }
+
+    if (cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+            perror("sched_setaffinity");
+            return 1;
+        }
+    }
+
+    _cleanup_(aoc_baseline_free) AocBaseline baseline = {0};
+    if (baseline_path != NULL && aoc_baseline_load(baseline_path, tolerance, &baseline)) return 1;
+
+    const AocDay *selected[MAX_DAYS];
+    int selected_count = aoc_days_select(&argv[optind], argc - optind, selected, ARRAY_LENGTH(selected));
+    if (selected_count < 0) return 1;
+
+    BenchResult results[MAX_DAYS];
+    size_t result_count = 0;
+    int rc = 0;
+    for (int i = 0; i < selected_count; i++) {
+        if (bench_day(selected[i], input_dir, warmup, iterations, &results[result_count])) {
+            rc = 1;
+            continue;
+        }
+        result_count++;
+    }
+
+    bool json_to_stdout = json_path != NULL && strcmp(json_path, "-") == 0;
+    if (!json_to_stdout) print_table(results, result_count);
+    if (json_path != NULL) {
+        FILE *f = json_to_stdout ? stdout : fopen(json_path, "w");
+        if (f == NULL) {
+            perror(json_path);
+            return 1;
+        }
+        write_json(f, results, result_count, warmup, iterations);
+        if (!json_to_stdout) fclose(f);
+    }
+    if (baseline_path != NULL && compare_baseline(json_to_stdout ? stderr : stdout, results, result_count, &baseline)) {
+        rc = 1;
+    }
+    return rc;
+}
@@ -0,0 +1,174 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "aoc/macros.h"
+#include "cache.h"
+
+#define CACHE_MAGIC "AOCCACH1" /* the digit is the version of the record layout */
+#define CACHE_DIR "aoc-2023"
+
+typedef struct {
+    char magic[8];
+    u64 record_size;
+} Header;
+
+typedef struct {
+    u64 input_hash[2]; /* XXH3_128: low, high */
+    u64 version;
+    char day[8];
+    char part1[sizeof(((Solution *)0)->part1)];
+    char part2[sizeof(((Solution *)0)->part2)];
+    u64 checksum; /* XXH3_64 of everything above */
+} Record;
+
+struct AocCache {
+    int fd;
+    pthread_mutex_t lock; /* flock() does not exclude the threads sharing fd */
+    const char *map; /* the file at the time it was opened */
+    size_t map_size;
+};
+
+static u64 record_checksum(const Record *record) { return XXH3_64bits(record, offsetof(Record, checksum)); }
+
+int aoc_cache_default_path(char *out, size_t out_size) {
+    const char *xdg = getenv("XDG_CACHE_HOME"), *home = getenv("HOME");
+    char dir[4096];
+    int n;
+    if (xdg != NULL && *xdg != '\0') {
+        n = snprintf(dir, sizeof(dir), "%s", xdg);
+    } else if (home != NULL && *home != '\0') {
+        n = snprintf(dir, sizeof(dir), "%s/.cache", home);
+    } else {
+        return -1;
+    }
+    if (n < 0 || (size_t)n >= sizeof(dir)) return -2;
+    mkdir(dir, 0755);
+    n = snprintf(out, out_size, "%s/" CACHE_DIR, dir);
+    if (n < 0 || (size_t)n >= out_size) return -2;
+    mkdir(out, 0755);
+    n = snprintf(out, out_size, "%s/" CACHE_DIR "/results", dir);
+    return n < 0 || (size_t)n >= out_size ? -2 : 0;
+}
+
+/* Writes the header of an empty file; files of another layout are not touched. */
+static int check_header(int fd, const char *path) {
+    Header header = {.magic = CACHE_MAGIC, .record_size = sizeof(Record)}, existing;
+    flock(fd, LOCK_EX);
+    ssize_t n = pread(fd, &existing, sizeof(existing), 0);
+    int rc = 0;
+    if (n == 0) {
+        if (write(fd, &header, sizeof(header)) != sizeof(header)) {
+            fprintf(stderr, "cache: failed to write %s: %s\n", path, strerror(errno));
+            rc = -1;
+        }
+    } else if (n != sizeof(existing) || memcmp(&existing, &header, sizeof(header)) != 0) {
+        fprintf(stderr, "cache: %s is not a cache file of this version\n", path);
+        rc = -1;
+    }
+    flock(fd, LOCK_UN);
+    return rc;
+}
+
+AocCache *aoc_cache_open(const char *path) {
+    int fd = open(path, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "cache: failed to open %s: %s\n", path, strerror(errno));
+        return NULL;
+    }
+    struct stat st;
+    if (check_header(fd, path) || fstat(fd, &st)) {
+        close(fd);
+        return NULL;
+    }
+
+    AocCache *cache = calloc(1, sizeof(*cache));
+    if (cache == NULL) {
+        fprintf(stderr, "cache: out of memory\n");
+        abort();
+    }
+    cache->fd = fd;
+    pthread_mutex_init(&cache->lock, NULL);
+    if ((size_t)st.st_size > sizeof(Header)) {
+        void *map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (map != MAP_FAILED) {
+            cache->map = map;
+            cache->map_size = st.st_size;
+        }
+    }
+    return cache;
+}
+
+void aoc_cache_close(AocCache **cache) {
+    AocCache *c = *cache;
+    if (c == NULL) return;
+    if (c->map) munmap((void *)c->map, c->map_size);
+    close(c->fd);
+    pthread_mutex_destroy(&c->lock);
+    free(c);
+    *cache = NULL;
+}
+
+static void make_record(Record *record, const char *day, u64 version, XXH128_hash_t input_hash) {
+    memset(record, 0, sizeof(*record));
+    record->input_hash[0] = input_hash.low64;
+    record->input_hash[1] = input_hash.high64;
+    record->version = version;
+    memcpy(record->day, day, strnlen(day, sizeof(record->day)));
+}
+
+bool aoc_cache_lookup(AocCache *cache, const char *day, u64 version, XXH128_hash_t input_hash, Solution *solution) {
+    if (cache->map == NULL) return false;
+    Record key;
+    make_record(&key, day, version, input_hash);
+    size_t count = (cache->map_size - sizeof(Header)) / sizeof(Record);
+    const Record *records = (const Record *)(cache->map + sizeof(Header));
+    for (size_t i = count; i-- > 0;) { // newest first
+        const Record *r = &records[i];
+        if (memcmp(r, &key, offsetof(Record, part1)) != 0 || r->checksum != record_checksum(r)) continue;
+        memcpy(solution->part1, r->part1, sizeof(r->part1));
+        memcpy(solution->part2, r->part2, sizeof(r->part2));
+        return true;
+    }
+    return false;
+}
+
+int aoc_cache_store(AocCache *cache, const char *day, u64 version, XXH128_hash_t input_hash,
+                    const Solution *solution) {
+    Record record;
+    make_record(&record, day, version, input_hash);
+    memcpy(record.part1, solution->part1, sizeof(record.part1));
+    memcpy(record.part2, solution->part2, sizeof(record.part2));
+    record.checksum = record_checksum(&record);
+
+    // keep the file a multiple of the record size, even after a torn write; the mutex keeps another thread from
+    // cutting off the record being appended
+    pthread_mutex_lock(&cache->lock);
+    flock(cache->fd, LOCK_EX);
+    int rc = 0;
+    struct stat st;
+    if (fstat(cache->fd, &st) == 0) {
+        size_t excess = (st.st_size - sizeof(Header)) % sizeof(Record);
+        if (excess && ftruncate(cache->fd, st.st_size - excess)) rc = -1;
+    }
+    if (rc == 0 && write(cache->fd, &record, sizeof(record)) != sizeof(record)) rc = -1;
+    flock(cache->fd, LOCK_UN);
+    pthread_mutex_unlock(&cache->lock);
+    if (rc) fprintf(stderr, "cache: failed to store %s: %s\n", day, strerror(errno));
+    return rc;
+}
@@ -0,0 +1,70 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <xxhash.h>
+
+#include "aoc/types.h"
+#include "solve.h"
+
+/**
+ * A persistent cache of solutions, keyed by day, solver version and the
+ * XXH3_128 hash of the input.
+ *
+ * The cache is an append-only file of fixed-size records. It is mapped
+ * read-only when it is opened, so lookups only see the records which
+ * existed at that time; new records are appended under an exclusive
+ * flock(2), so several processes can share the file. Records are
+ * checksummed, a torn record of a crashed writer is ignored.
+ *
+ * Lookups and stores are thread-safe: stores of the threads of a process are
+ * serialized by a mutex, as flock(2) only excludes other open files.
+ */
+typedef struct AocCache AocCache;
+
+/**
+ * Returns the default location of the cache file,
+ * $XDG_CACHE_HOME/aoc-2023/results (or ~/.cache/aoc-2023/results), creating
+ * its directory if necessary.
+ *
+ * @return 0 on success, a negative value if there is no home directory or the
+ * path does not fit into `out`.
+ */
+int aoc_cache_default_path(char *out, size_t out_size);
+
+/**
+ * Opens or creates the cache file `path`.
+ *
+ * @return The cache or NULL on error (reported to stderr).
+ */
+AocCache *aoc_cache_open(const char *path);
+
+/**
+ * Closes the cache. Suitable for use with _cleanup_().
+ */
+void aoc_cache_close(AocCache **cache);
+
+/**
+ * Looks up the solution of `day` (e.g. "day01") for an input with hash
+ * `input_hash`, computed by a solver of version `version`.
+ *
+ * @return true on a hit, in which case `solution` receives the parts.
+ */
+bool aoc_cache_lookup(AocCache *cache, const char *day, u64 version, XXH128_hash_t input_hash, Solution *solution);
+
+/**
+ * Appends a solution to the cache file.
+ *
+ * @return 0 on success, a negative value on error.
+ */
+int aoc_cache_store(AocCache *cache, const char *day, u64 version, XXH128_hash_t input_hash,
+                    const Solution *solution);
@@ -0,0 +1,233 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Load generator for `aoc --serve`.
+ *
+ * Every connection runs on its own thread and sends its requests one after
+ * the other (a closed loop), so the throughput is limited by the server and
+ * the latency of a request includes its transfer but no queueing in the
+ * client.
+ */
+
+#include <errno.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "aoc/io.h"
+#include "aoc/macros.h"
+#include "aoc/time.h"
+#include "runner.h"
+#include "serve.h"
+#include "stats.h"
+
+typedef struct {
+    const char *socket_path;
+    AocRequest request;
+    const char *body; /* the input or its path */
+    int requests;
+
+    int rc;
+    u64 *latencies; /* ns, one per request */
+    u64 solve_ns;   /* sum over all requests, as reported by the server */
+    AocResponse first;
+} Connection;
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [OPTIONS] SOCKET DAY [INPUT]\n"
+            "\n"
+            "Sends INPUT (default: input/DAY.txt) to the solver daemon (aoc --serve) listening on\n"
+            "SOCKET and reports requests per second and the latency distribution.\n"
+            "\n"
+            "Options:\n"
+            "  -c, --connections N  concurrent connections, one thread each (default: 1)\n"
+            "  -n, --requests N     requests per connection (default: 1000)\n"
+            "  -p, --path           send the path of INPUT instead of its contents\n"
+            "  -h, --help           show this help\n",
+            prog);
+}
+
+static int connect_to(const char *path) {
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path);
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr))) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static int send_request(int fd, const AocRequest *request, const char *body) {
+    struct iovec iov[2] = {{.iov_base = (void *)request, .iov_len = sizeof(*request)},
+                           {.iov_base = (void *)body, .iov_len = request->length}};
+    size_t left = sizeof(*request) + request->length;
+    while (left > 0) {
+        ssize_t n = writev(fd, iov, 2);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        left -= n;
+        for (int i = 0; i < 2; i++) { // skip what was sent
+            size_t skip = MIN((size_t)n, iov[i].iov_len);
+            iov[i].iov_base = (char *)iov[i].iov_base + skip;
+            iov[i].iov_len -= skip;
+            n -= skip;
+        }
+    }
+    return 0;
+}
+
+static int read_response(int fd, AocResponse *response) {
+    for (size_t done = 0; done < sizeof(*response);) {
+        ssize_t n = read(fd, (char *)response + done, sizeof(*response) - done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        done += n;
+    }
+    return 0;
+}
+
+static void *run_connection(void *arg) {
+    Connection *conn = arg;
+    int fd = connect_to(conn->socket_path);
+    if (fd < 0) {
+        fprintf(stderr, "failed to connect to %s: %s\n", conn->socket_path, strerror(errno));
+        conn->rc = -1;
+        return NULL;
+    }
+    for (int i = 0; i < conn->requests; i++) {
+        AocResponse response;
+        u64 start = aoc_time_now_ns();
+        if (send_request(fd, &conn->request, conn->body) || read_response(fd, &response)) {
+            fprintf(stderr, "connection closed by the server\n");
+            conn->rc = -1;
+            break;
+        }
+        conn->latencies[i] = aoc_time_now_ns() - start;
+        conn->solve_ns += response.solve_ns;
+        if (i == 0) conn->first = response;
+        if (response.status != AOC_RESPONSE_OK) {
+            fprintf(stderr, "request failed with status %u\n", response.status);
+            conn->rc = -1;
+            break;
+        }
+    }
+    close(fd);
+    return NULL;
+}
+
+int main(int argc, char *argv[]) {
+    int connections = 1, requests = 1000;
+    bool send_path = false;
+
+    static const struct option options[] = {
+        {"connections", required_argument, NULL, 'c'},
+        {"requests", required_argument, NULL, 'n'},
+        {"path", no_argument, NULL, 'p'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0},
+    };
+    int opt;
+    while ((opt = getopt_long(argc, argv, "c:n:ph", options, NULL)) != -1) {
+        switch (opt) {
+        case 'c': connections = atoi(optarg); break;
+        case 'n': requests = atoi(optarg); break;
+        case 'p': send_path = true; break;
+        case 'h': usage(argv[0]); return 0;
+        default: usage(argv[0]); return 1;
+        }
+    }
+    if (argc - optind < 2 || argc - optind > 3 || connections <= 0 || requests <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+    const char *socket_path = argv[optind], *day = argv[optind + 1];
+    char input_path[4096];
+    if (optind + 2 < argc) {
+        snprintf(input_path, sizeof(input_path), "%s", argv[optind + 2]);
+    } else {
+        const char *digits = strncmp(day, "day", 3) == 0 ? day + 3 : day;
+        snprintf(input_path, sizeof(input_path), "input/day%02d.txt", atoi(digits));
+    }
+
+    AocRequest request = {.magic = AOC_SERVE_MAGIC};
+    memcpy(request.day, day, strnlen(day, sizeof(request.day)));
+    _cleanup_(aoc_io_unmap_input) AocInput input = {0};
+    const char *body;
+    if (send_path) {
+        // the server resolves relative paths against its own working directory
+        char *absolute = realpath(input_path, NULL);
+        body = absolute ? absolute : input_path;
+        request.kind = AOC_REQUEST_PATH;
+        request.length = strlen(body);
+    } else {
+        if (aoc_io_map_input(input_path, &input)) {
+            fprintf(stderr, "failed to read %s\n", input_path);
+            return 1;
+        }
+        body = input.buf;
+        request.kind = AOC_REQUEST_INPUT;
+        request.length = input.size;
+    }
+
+    Connection *conns = calloc(connections, sizeof(Connection));
+    pthread_t *threads = calloc(connections, sizeof(pthread_t));
+    u64 *latencies = calloc((size_t)connections * requests, sizeof(u64));
+    if (conns == NULL || threads == NULL || latencies == NULL) abort();
+
+    u64 start = aoc_time_now_ns();
+    for (int i = 0; i < connections; i++) {
+        conns[i] = (Connection){.socket_path = socket_path,
+                                .request = request,
+                                .body = body,
+                                .requests = requests,
+                                .latencies = &latencies[(size_t)i * requests]};
+        pthread_create(&threads[i], NULL, run_connection, &conns[i]);
+    }
+    for (int i = 0; i < connections; i++) pthread_join(threads[i], NULL);
+    u64 elapsed = aoc_time_now_ns() - start;
+
+    int rc = 0;
+    u64 solve_ns = 0;
+    for (int i = 0; i < connections; i++) {
+        rc |= conns[i].rc;
+        solve_ns += conns[i].solve_ns;
+    }
+    if (rc == 0) {
+        size_t total = (size_t)connections * requests;
+        AocStats stats;
+        aoc_stats_compute(latencies, total, &stats);
+        char t_min[32], t_median[32], t_p99[32], t_max[32], t_solve[32];
+        aoc_format_duration(stats.min, t_min, sizeof(t_min));
+        aoc_format_duration(stats.median, t_median, sizeof(t_median));
+        aoc_format_duration(stats.p99, t_p99, sizeof(t_p99));
+        aoc_format_duration(stats.max, t_max, sizeof(t_max));
+        aoc_format_duration(solve_ns / total, t_solve, sizeof(t_solve));
+        printf("Part1: %s\nPart2: %s\n", conns[0].first.part1, conns[0].first.part2);
+        printf("%zu requests on %d connections in %.2f s: %.0f requests/s\n", total, connections, elapsed / 1e9,
+               total / (elapsed / 1e9));
+        printf("latency: min %s, median %s, p99 %s, max %s (mean solve() %s)\n", t_min, t_median, t_p99, t_max,
+               t_solve);
+    }
+
+    if (send_path && body != input_path) free((char *)body);
+    free(latencies);
+    free(threads);
+    free(conns);
+    return rc ? 1 : 0;
+}
@@ -0,0 +1,115 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "aoc/macros.h"
+#include "aoc_days.h"            // generated by meson, defines AOC_DAYS
+#include "aoc_solver_versions.h" // generated by scripts/solver-versions.sh
+#include "days.h"
+
+/*
+ * every day is compiled with solve/solve_input/solve_stream renamed to
+ * dayXX_solve/dayXX_solve_input/dayXX_solve_stream; solve_stream is optional,
+ * hence weak (NULL if the day does not implement it)
+ */
+#define X(day)                                                                                                         \
+    void day##_solve(char *buf, size_t buf_size, Solution *result);                                                    \
+    int day##_solve_input(const char *fname, Solution *result);                                                        \
+    __attribute__((weak)) int day##_solve_stream(AocStream *stream, Solution *result);
+AOC_DAYS
+#undef X
+
+const AocDay aoc_days[] = {
+#define X(day)                                                                                                         \
+    {.name = #day,                                                                                                     \
+     .solve = day##_solve,                                                                                             \
+     .solve_input = day##_solve_input,                                                                                 \
+     .solve_stream = day##_solve_stream,                                                                               \
+     .version = AOC_SOLVER_VERSION_##day},
+    AOC_DAYS
+#undef X
+};
+
+const size_t aoc_days_count = sizeof(aoc_days) / sizeof(aoc_days[0]);
+
+/* single-run times on an Intel i7-11850H (see README.md) */
+static const struct {
+    const char *name;
+    u64 ns;
+} expected_costs[] = {
+    {"day01", 276000},
+    {"day02", 185000},
+    {"day03", 231000},
+    {"day04", 368000},
+    {"day05", 1400000000},
+    {"day06", 200000},
+    {"day07", 2600000},
+    {"day08", 462400},
+    {"day09", 256000},
+    {"day10", 5800000},
+    {"day11", 980000},
+    {"day12", 347000000},
+    {"day13", 248000},
+    {"day14", 44000000},
+    {"day15", 1100000},
+    {"day16", 34400000},
+    {"day17", 315300000},
+    {"day18", 173000},
+    {"day19", 422000},
+    {"day20", 16800000},
+};
+
+const AocDay *aoc_day_find(const char *name) {
+    if (strncmp(name, "day", 3) == 0) name += 3;
+    char *end;
+    long number = strtol(name, &end, 10);
+    if (end == name || *end != '\0') return NULL;
+
+    char wanted[16];
+    snprintf(wanted, sizeof(wanted), "day%02ld", number);
+    for (size_t i = 0; i < aoc_days_count; i++) {
+        if (strcmp(aoc_days[i].name, wanted) == 0) return &aoc_days[i];
+    }
+    return NULL;
+}
+
+u64 aoc_day_expected_ns(const AocDay *day) {
+    for (size_t i = 0; i < ARRAY_LENGTH(expected_costs); i++) {
+        if (strcmp(expected_costs[i].name, day->name) == 0) return expected_costs[i].ns;
+    }
+    return 1000000;
+}
+
+void aoc_day_input_path(const AocDay *day, const char *dir, char *out, size_t out_size) {
+    snprintf(out, out_size, "%s/%s.txt", dir ? dir : "input", day->name);
+}
+
+int aoc_days_select(char *names[], int count, const AocDay *out[], size_t out_size) {
+    size_t n = 0;
+    if (count == 0) {
+        if (aoc_days_count > out_size) return -1;
+        for (size_t i = 0; i < aoc_days_count; i++) { out[n++] = &aoc_days[i]; }
+        return n;
+    }
+    for (int i = 0; i < count; i++) {
+        const AocDay *day = aoc_day_find(names[i]);
+        if (day == NULL) {
+            fprintf(stderr, "unknown day: %s\n", names[i]);
+            return -1;
+        }
+        if (n == out_size) {
+            fprintf(stderr, "too many days given\n");
+            return -1;
+        }
+        out[n++] = day;
+    }
+    return n;
+}
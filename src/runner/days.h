@@ -0,0 +1,54 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#include "aoc/types.h"
+#include "solve.h"
+
+typedef struct {
+    const char *name; /* e.g. "day01" */
+    void (*solve)(char *buf, size_t buf_size, Solution *result);
+    int (*solve_input)(const char *fname, Solution *result);
+    int (*solve_stream)(AocStream *stream, Solution *result); /* NULL unless the day supports streaming */
+    u64 version; /* hash of the sources of the day, for the result cache */
+} AocDay;
+
+/* All days linked into the runner, sorted by day. */
+extern const AocDay aoc_days[];
+extern const size_t aoc_days_count;
+
+/**
+ * Looks up a day by name. Accepts "day01", "01" and "1".
+ *
+ * @return The matching day or NULL if there is none.
+ */
+const AocDay *aoc_day_find(const char *name);
+
+/**
+ * Returns the expected duration of a single solve() call of `day`, used to
+ * schedule expensive days first. Days without a known cost get 1 ms.
+ */
+u64 aoc_day_expected_ns(const AocDay *day);
+
+/**
+ * Writes the input path of `day` in directory `dir` ("DIR/dayXX.txt") to `out`.
+ * If `dir` is NULL, the default input directory "input" is used.
+ */
+void aoc_day_input_path(const AocDay *day, const char *dir, char *out, size_t out_size);
+
+/**
+ * Resolves the day names in `names` (see aoc_day_find()) and stores them in
+ * `out`. If `count` is zero, all days are selected.
+ *
+ * @return The number of selected days, or a negative value if a name is
+ * unknown or more than `out_size` days are selected.
+ */
+int aoc_days_select(char *names[], int count, const AocDay *out[], size_t out_size);
@@ -0,0 +1,807 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Generates synthetic puzzle inputs of arbitrary size, to measure how the
+ * solvers scale.
+ *
+ * The inputs are valid in the sense of the puzzles: every day's solver finds
+ * a solution (e.g. day 8 has a path from AAA to ZZZ, day 10 a single loop and
+ * day 13 exactly one reflection and one smudge per pattern). The same seed
+ * and size always produce the same input.
+ */
+
+#include <getopt.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "aoc/macros.h"
+#include "aoc/types.h"
+
+/* splitmix64, see https://prng.di.unimi.it/splitmix64.c */
+typedef struct {
+    u64 state;
+} Rng;
+
+static u64 rng_next(Rng *rng) {
+    u64 z = (rng->state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/* A uniformly distributed number in [lo, hi]. */
+static i64 rng_range(Rng *rng, i64 lo, i64 hi) { return lo + (i64)(rng_next(rng) % (u64)(hi - lo + 1)); }
+
+static bool rng_chance(Rng *rng, double p) { return (rng_next(rng) >> 11) * 0x1.0p-53 < p; }
+
+static char rng_pick(Rng *rng, const char *chars) { return chars[rng_range(rng, 0, strlen(chars) - 1)]; }
+
+static void shuffle(Rng *rng, int items[], int count) {
+    for (int i = count - 1; i > 0; i--) {
+        int j = rng_range(rng, 0, i), tmp = items[i];
+        items[i] = items[j];
+        items[j] = tmp;
+    }
+}
+
+static void *xcalloc(size_t count, size_t size) {
+    void *ptr = calloc(count, size);
+    if (ptr == NULL) {
+        fprintf(stderr, "gen: out of memory\n");
+        exit(1);
+    }
+    return ptr;
+}
+
+/* Writes a random grid of `side` x `side` cells, each one of `chars` with the given weights (in percent). */
+static void random_grid(Rng *rng, FILE *out, long side, const char *chars, const int weights[]) {
+    for (long y = 0; y < side; y++) {
+        for (long x = 0; x < side; x++) {
+            int r = rng_range(rng, 0, 99), i = 0;
+            while (chars[i + 1] && r >= weights[i]) r -= weights[i++];
+            fputc(chars[i], out);
+        }
+        fputc('\n', out);
+    }
+}
+
+/*
+ * A random simple loop: the border of a randomly grown tree of 3 cells wide
+ * corridors on a `side` x `side` grid. `loop` receives the cells of the loop
+ * in order (clockwise, with y pointing down); the cells enclosed by it are
+ * the center lines of the corridors.
+ */
+typedef struct {
+    int x, y;
+} Cell;
+
+static long random_loop(Rng *rng, long side, Cell **loop) {
+    int nodes = MAX(2, (side + 1) / 4);
+    bool *in_tree = xcalloc(nodes * nodes, sizeof(bool));
+    bool *grid = xcalloc(side * side, sizeof(bool));
+#define FILL(cx, cy)                                                                                                   \
+    for (int dy = -1; dy <= 1; dy++)                                                                                   \
+        for (int dx = -1; dx <= 1; dx++) grid[((cy) + dy) * side + (cx) + dx] = true
+
+    // grow a random tree over ~60% of the nodes, each one connected to a random neighbor already in the tree
+    int *frontier = xcalloc(nodes * nodes * 4, sizeof(int)), frontier_count = 0;
+    int target = MAX(2, nodes * nodes * 3 / 5), count = 1;
+    int start = rng_range(rng, 0, nodes * nodes - 1);
+    in_tree[start] = true;
+    FILL(4 * (start % nodes) + 1, 4 * (start / nodes) + 1);
+    frontier[frontier_count++] = start;
+    while (count < target && frontier_count > 0) {
+        int f = rng_range(rng, 0, frontier_count - 1), node = frontier[f];
+        int nx = node % nodes, ny = node / nodes;
+        int dirs[] = {0, 1, 2, 3};
+        shuffle(rng, dirs, 4);
+        bool grown = false;
+        for (int i = 0; i < 4 && !grown; i++) {
+            static const int DX[] = {1, 0, -1, 0}, DY[] = {0, 1, 0, -1};
+            int mx = nx + DX[dirs[i]], my = ny + DY[dirs[i]];
+            if (mx < 0 || my < 0 || mx >= nodes || my >= nodes || in_tree[my * nodes + mx]) continue;
+            in_tree[my * nodes + mx] = true;
+            for (int k = 0; k <= 4; k++) FILL(4 * nx + 1 + k * DX[dirs[i]], 4 * ny + 1 + k * DY[dirs[i]]);
+            frontier[frontier_count++] = my * nodes + mx;
+            count++;
+            grown = true;
+        }
+        if (!grown) frontier[f] = frontier[--frontier_count];
+    }
+#undef FILL
+
+    // the loop consists of the corridor cells next to a cell outside of the corridors
+#define INSIDE(x, y) ((x) >= 0 && (y) >= 0 && (x) < side && (y) < side && grid[(y) * side + (x)])
+#define ON_LOOP(x, y)                                                                                                  \
+    (INSIDE(x, y) && !(INSIDE((x)-1, (y)-1) && INSIDE(x, (y)-1) && INSIDE((x) + 1, (y)-1) && INSIDE((x)-1, y) &&       \
+                       INSIDE((x) + 1, y) && INSIDE((x)-1, (y) + 1) && INSIDE(x, (y) + 1) && INSIDE((x) + 1, (y) + 1)))
+    long length = 0;
+    Cell first = {-1, -1};
+    for (int y = 0; y < side; y++) {
+        for (int x = 0; x < side; x++) {
+            if (!ON_LOOP(x, y)) continue;
+            if (length++ == 0) first = (Cell){x, y};
+        }
+    }
+    *loop = xcalloc(length, sizeof(Cell));
+    // `first` is the topmost, leftmost cell, so walking east first goes clockwise
+    Cell prev = first, current = first;
+    for (long i = 0; i < length; i++) {
+        (*loop)[i] = current;
+        static const int DX[] = {1, 0, -1, 0}, DY[] = {0, 1, 0, -1};
+        for (int d = 0; d < 4; d++) {
+            Cell next = {current.x + DX[d], current.y + DY[d]};
+            if ((next.x != prev.x || next.y != prev.y) && ON_LOOP(next.x, next.y)) {
+                prev = current;
+                current = next;
+                break;
+            }
+        }
+    }
+#undef ON_LOOP
+#undef INSIDE
+    free(frontier);
+    free(grid);
+    free(in_tree);
+    return length;
+}
+
+/* Lines of letters and digits, some digits spelled out. */
+static void gen_day01(Rng *rng, long size, FILE *out) {
+    static const char *words[] = {"one", "two", "three", "four", "five", "six", "seven", "eight", "nine"};
+    for (long i = 0; i < size; i++) {
+        int len = rng_range(rng, 3, 12);
+        int digit_at = rng_range(rng, 0, len - 1);
+        for (int j = 0; j < len; j++) {
+            if (j == digit_at || rng_chance(rng, 0.15)) {
+                fputc('1' + rng_range(rng, 0, 8), out);
+            } else if (rng_chance(rng, 0.2)) {
+                fputs(words[rng_range(rng, 0, 8)], out);
+            } else {
+                fputc('a' + rng_range(rng, 0, 25), out);
+            }
+        }
+        fputc('\n', out);
+    }
+}
+
+static void gen_day02(Rng *rng, long size, FILE *out) {
+    static const char *colors[] = {"red", "green", "blue"};
+    for (long i = 1; i <= size; i++) {
+        fprintf(out, "Game %ld:", i);
+        int draws = rng_range(rng, 1, 6);
+        for (int d = 0; d < draws; d++) {
+            int order[] = {0, 1, 2}, count = rng_range(rng, 1, 3);
+            shuffle(rng, order, 3);
+            for (int c = 0; c < count; c++) {
+                fprintf(out, "%s %d %s", c == 0 ? (d == 0 ? "" : ";") : ",", (int)rng_range(rng, 1, 20),
+                        colors[order[c]]);
+            }
+        }
+        fputc('\n', out);
+    }
+}
+
+/* Part numbers and symbols, with the density of the real input. */
+static void gen_day03(Rng *rng, long size, FILE *out) {
+    for (long y = 0; y < size; y++) {
+        for (long x = 0; x < size;) {
+            int digits = rng_range(rng, 1, 3);
+            if (x + digits < size && rng_chance(rng, 0.12)) {
+                fprintf(out, "%d", (int)rng_range(rng, digits == 1 ? 1 : digits == 2 ? 10 : 100,
+                                                  digits == 1 ? 9 : digits == 2 ? 99 : 999));
+                fputc('.', out);
+                x += digits + 1;
+            } else {
+                fputc(rng_chance(rng, 0.04) ? rng_pick(rng, "*#+$/@%=&-") : '.', out);
+                x++;
+            }
+        }
+        fputc('\n', out);
+    }
+}
+
+/* Most cards win nothing, so that the number of copies (part 2) stays bounded. */
+static void gen_day04(Rng *rng, long size, FILE *out) {
+    int width = snprintf(NULL, 0, "%ld", size);
+    for (long i = 1; i <= size; i++) {
+        int numbers[99];
+        for (int n = 0; n < 99; n++) numbers[n] = n + 1;
+        shuffle(rng, numbers, 99);
+        // numbers[0..10) are the winning ones, numbers[10..35) are the ones we have
+        int matches = rng_chance(rng, 0.8) ? 0 : rng_range(rng, 1, 4);
+        matches = MIN(matches, size - i);
+        int have[25];
+        for (int n = 0; n < 25; n++) have[n] = n < matches ? numbers[n] : numbers[10 + n];
+        shuffle(rng, have, 25);
+
+        fprintf(out, "Card %*ld:", width, i);
+        for (int n = 0; n < 10; n++) fprintf(out, " %2d", numbers[n]);
+        fputs(" |", out);
+        for (int n = 0; n < 25; n++) fprintf(out, " %2d", have[n]);
+        fputc('\n', out);
+    }
+}
+
+/* Every map is a permutation of [0, 2^32) into `size` ranges. */
+static void gen_day05(Rng *rng, long size, FILE *out) {
+    static const char *categories[] = {"seed",  "soil",        "fertilizer", "water",
+                                       "light", "temperature", "humidity",   "location"};
+    const i64 limit = 1ll << 32;
+    fputs("seeds:", out);
+    for (int i = 0; i < 10; i++) {
+        i64 start = rng_range(rng, 0, limit - 1);
+        fprintf(out, " %ld %ld", start, rng_range(rng, 1, MIN(limit - start, limit / 50)));
+    }
+    fputs("\n", out);
+
+    i64 *cuts = xcalloc(size + 1, sizeof(i64));
+    int *order = xcalloc(size, sizeof(int));
+    for (int c = 0; c + 1 < (int)ARRAY_LENGTH(categories); c++) {
+        fprintf(out, "\n%s-to-%s map:\n", categories[c], categories[c + 1]);
+        // distinct sorted cut points
+        cuts[0] = 0;
+        cuts[size] = limit;
+        for (long i = 1; i < size; i++) {
+            cuts[i] = cuts[i - 1] + 1 + rng_range(rng, 0, (limit - cuts[i - 1]) / (size - i + 1));
+        }
+        for (long i = 0; i < size; i++) order[i] = i;
+        shuffle(rng, order, size);
+        i64 dst = 0;
+        for (long i = 0; i < size; i++) {
+            int r = order[i];
+            i64 len = cuts[r + 1] - cuts[r];
+            fprintf(out, "%ld %ld %ld\n", dst, cuts[r], len);
+            dst += len;
+        }
+    }
+    free(order);
+    free(cuts);
+}
+
+/* The concatenation of all times (part 2) must stay within 64 bits, so the times get shorter as `size` grows. */
+static void gen_day06(Rng *rng, long size, FILE *out) {
+    int digits = MAX(1, 9 / size);
+    i64 lo = 1, time[64], record[64];
+    for (int i = 1; i < digits; i++) lo *= 10;
+    for (long i = 0; i < size && i < 64; i++) {
+        time[i] = rng_range(rng, MAX(lo, 3), 10 * lo - 1);
+        record[i] = time[i] * time[i] / 4 * rng_range(rng, 50, 90) / 100;
+    }
+    fputs("Time:    ", out);
+    for (long i = 0; i < size && i < 64; i++) fprintf(out, " %6ld", time[i]);
+    fputs("\nDistance:", out);
+    for (long i = 0; i < size && i < 64; i++) fprintf(out, " %6ld", record[i]);
+    fputc('\n', out);
+}
+
+static void gen_day07(Rng *rng, long size, FILE *out) {
+    for (long i = 0; i < size; i++) {
+        for (int c = 0; c < 5; c++) fputc(rng_pick(rng, "23456789TJQKA"), out);
+        fprintf(out, " %d\n", (int)rng_range(rng, 1, 1000));
+    }
+}
+
+/*
+ * Six ghosts, each on a path of n * p steps to its Z node, for small distinct
+ * primes p; ghost 0 walks from AAA to ZZZ. The turns which are not taken
+ * point to random nodes of the same path.
+ */
+static void gen_day08(Rng *rng, long size, FILE *out) {
+    static const int primes[] = {11, 13, 17, 19, 23, 29};
+    const int ghosts = ARRAY_LENGTH(primes);
+    int n = MAX(1, size / 112); // 112 = sum of the primes
+
+    int instruction_count = rng_range(rng, 50, 299);
+    char instructions[300];
+    for (int i = 0; i < instruction_count; i++) instructions[i] = rng_pick(rng, "LR");
+    fprintf(out, "%.*s\n\n", instruction_count, instructions);
+
+    // the nodes on the way end with neither 'A' nor 'Z'
+    int *labels = xcalloc(26 * 26 * 24, sizeof(int)), label_count = 0;
+    for (int i = 0; i < 26 * 26 * 26; i++) {
+        if (i % 26 != 0 && i % 26 != 25) labels[label_count++] = i;
+    }
+    shuffle(rng, labels, label_count);
+    int next_label = 0;
+    // the start and Z node of a ghost share a unique prefix; AA (and ZZ) is reserved for ghost 0
+    int prefixes[26 * 26];
+    for (int i = 0; i < 26 * 26; i++) prefixes[i] = i;
+    shuffle(rng, prefixes, 26 * 26);
+    int next_prefix = 0;
+
+    for (int g = 0; g < ghosts; g++) {
+        int steps = n * primes[g];
+        char(*path)[4] = xcalloc(steps + 1, sizeof(*path));
+        for (int i = 1; i < steps; i++) {
+            int label = labels[next_label++ % label_count];
+            snprintf(path[i], sizeof(path[i]), "%c%c%c", 'A' + label / 676, 'A' + label / 26 % 26, 'A' + label % 26);
+        }
+        int prefix = 0;
+        while (g > 0 && (prefix == 0 || prefix == 26 * 26 - 1)) prefix = prefixes[next_prefix++];
+        snprintf(path[0], sizeof(path[0]), "%c%cA", 'A' + prefix / 26, 'A' + prefix % 26);
+        snprintf(path[steps], sizeof(path[steps]), "%c%cZ", 'A' + prefix / 26, 'A' + prefix % 26);
+        if (g == 0) memcpy(path[steps], "ZZZ", 3);
+        for (int i = 0; i <= steps; i++) {
+            // step i is taken from path[i], the Z node loops back to the start of its path
+            const char *next = i < steps ? path[i + 1] : path[1];
+            const char *other = path[rng_range(rng, 0, steps)];
+            bool left = i == steps || instructions[i % instruction_count] == 'L';
+            fprintf(out, "%s = (%s, %s)\n", path[i], left ? next : other, left ? other : next);
+        }
+        free(path);
+    }
+    free(labels);
+}
+
+/* Polynomials of degree up to 6, given in the binomial basis. */
+static void gen_day09(Rng *rng, long size, FILE *out) {
+    for (long i = 0; i < size; i++) {
+        int degree = rng_range(rng, 1, 6);
+        i64 coeff[7];
+        for (int d = 0; d <= degree; d++) coeff[d] = rng_range(rng, -10, 10);
+        for (int x = 0; x < 21; x++) {
+            i64 value = 0, binomial = 1; // binomial(x, d)
+            for (int d = 0; d <= degree; d++) {
+                value += coeff[d] * binomial;
+                binomial = binomial * (x - d) / (d + 1);
+            }
+            fprintf(out, x == 0 ? "%ld" : " %ld", value);
+        }
+        fputc('\n', out);
+    }
+}
+
+/* A random loop (see random_loop()) in between junk pipes. */
+static void gen_day10(Rng *rng, long size, FILE *out) {
+    size = MAX(size, 7);
+    char *grid = xcalloc(size * (size + 1), 1);
+    for (long y = 0; y < size; y++) {
+        for (long x = 0; x < size; x++) grid[y * (size + 1) + x] = rng_pick(rng, "|-LJ7F...");
+        grid[y * (size + 1) + size] = '\n';
+    }
+    Cell *loop;
+    long length = random_loop(rng, size, &loop);
+    for (long i = 0; i < length; i++) {
+        Cell prev = loop[(i + length - 1) % length], c = loop[i], next = loop[(i + 1) % length];
+        bool n = prev.y < c.y || next.y < c.y, s = prev.y > c.y || next.y > c.y;
+        bool w = prev.x < c.x || next.x < c.x, e = prev.x > c.x || next.x > c.x;
+        grid[c.y * (size + 1) + c.x] = n && s ? '|' : w && e ? '-' : n && e ? 'L' : n && w ? 'J' : s && w ? '7' : 'F';
+    }
+    long s = rng_range(rng, 0, length - 1);
+    Cell start = loop[s], prev = loop[(s + length - 1) % length], next = loop[(s + 1) % length];
+    grid[start.y * (size + 1) + start.x] = 'S';
+    // only the loop may connect to S
+    static const int DX[] = {1, 0, -1, 0}, DY[] = {0, 1, 0, -1};
+    static const char *towards[] = {"-J7", "|LJ", "-LF", "|7F"}; // pipes pointing back at S from each direction
+    for (int d = 0; d < 4; d++) {
+        Cell c = {start.x + DX[d], start.y + DY[d]};
+        if (c.x < 0 || c.y < 0 || c.x >= size || c.y >= size) continue;
+        if ((c.x == prev.x && c.y == prev.y) || (c.x == next.x && c.y == next.y)) continue;
+        if (strchr(towards[d], grid[c.y * (size + 1) + c.x])) grid[c.y * (size + 1) + c.x] = '.';
+    }
+    fwrite(grid, 1, size * (size + 1), out);
+    free(loop);
+    free(grid);
+}
+
+/* Three galaxies per row on average, as in the real input. */
+static void gen_day11(Rng *rng, long size, FILE *out) {
+    for (long y = 0; y < size; y++) {
+        bool empty = rng_chance(rng, 0.05);
+        for (long x = 0; x < size; x++) fputc(!empty && rng_chance(rng, 3.0 / size) ? '#' : '.', out);
+        fputc('\n', out);
+    }
+}
+
+/* Random rows of springs, some of which are then damaged to '?'; at most 6 groups, as in the real input. */
+static void gen_day12(Rng *rng, long size, FILE *out) {
+    for (long i = 0; i < size; i++) {
+        char springs[20];
+        int len, groups[20], group_count;
+        do {
+            len = rng_range(rng, 4, 20), group_count = 0;
+            for (int j = 0; j < len; j++) springs[j] = rng_chance(rng, 0.45) ? '#' : '.';
+            for (int j = 0; j < len;) {
+                if (springs[j] != '#') {
+                    j++;
+                    continue;
+                }
+                int start = j;
+                while (j < len && springs[j] == '#') j++;
+                groups[group_count++] = j - start;
+            }
+        } while (group_count == 0 || group_count > 6);
+        for (int j = 0; j < len; j++) {
+            if (rng_chance(rng, 0.5)) springs[j] = '?';
+        }
+        fprintf(out, "%.*s ", len, springs);
+        for (int g = 0; g < group_count; g++) fprintf(out, g == 0 ? "%d" : ",%d", groups[g]);
+        fputc('\n', out);
+    }
+}
+
+#define D13_MAX 17
+
+typedef struct {
+    int rows, cols;
+    bool cell[D13_MAX][D13_MAX];
+} Pattern;
+
+/* Number of differing cells of the reflection in front of row (`horizontal`) or column `line`. */
+static int smudges(const Pattern *p, bool horizontal, int line) {
+    int count = 0, n = horizontal ? p->rows : p->cols, m = horizontal ? p->cols : p->rows;
+    for (int a = line - 1, b = line; a >= 0 && b < n; a--, b++) {
+        for (int k = 0; k < m; k++) {
+            count += horizontal ? p->cell[a][k] != p->cell[b][k] : p->cell[k][a] != p->cell[k][b];
+        }
+    }
+    return count;
+}
+
+static int find(int parent[], int i) {
+    while (parent[i] != i) i = parent[i] = parent[parent[i]];
+    return i;
+}
+
+/*
+ * A pattern which is symmetric along a horizontal line A, and along a
+ * vertical line B but for one cell (the smudge) in a row A does not reflect.
+ * Patterns with any other (almost) reflections are rejected.
+ */
+static void random_pattern(Rng *rng, Pattern *p) {
+    while (1) {
+        p->rows = rng_range(rng, 5, D13_MAX), p->cols = rng_range(rng, 5, D13_MAX);
+        int a = rng_range(rng, 1, p->rows - 1), b = rng_range(rng, 1, p->cols - 1);
+        if (2 * a == p->rows) continue; // every row is reflected, so there is no row for the smudge
+
+        int parent[D13_MAX * D13_MAX];
+        for (int i = 0; i < D13_MAX * D13_MAX; i++) parent[i] = i;
+        for (int y = 0; y < p->rows; y++) {
+            for (int x = 0; x < p->cols; x++) {
+                int ya = 2 * a - 1 - y, xb = 2 * b - 1 - x;
+                if (ya >= 0 && ya < p->rows) parent[find(parent, y * D13_MAX + x)] = find(parent, ya * D13_MAX + x);
+                if (xb >= 0 && xb < p->cols) parent[find(parent, y * D13_MAX + x)] = find(parent, y * D13_MAX + xb);
+            }
+        }
+        bool value[D13_MAX * D13_MAX];
+        for (int i = 0; i < D13_MAX * D13_MAX; i++) value[i] = rng_chance(rng, 0.5);
+        for (int y = 0; y < p->rows; y++) {
+            for (int x = 0; x < p->cols; x++) p->cell[y][x] = value[find(parent, y * D13_MAX + x)];
+        }
+
+        int y = a < p->rows - a ? rng_range(rng, 2 * a, p->rows - 1) : rng_range(rng, 0, 2 * a - p->rows - 1);
+        int x = rng_range(rng, MAX(0, 2 * b - p->cols), MIN(p->cols - 1, 2 * b - 1));
+        p->cell[y][x] = !p->cell[y][x];
+
+        bool unique = true;
+        for (int line = 1; line < p->rows && unique; line++) {
+            int s = smudges(p, true, line);
+            unique = line == a ? s == 0 : s > 1;
+        }
+        for (int line = 1; line < p->cols && unique; line++) {
+            int s = smudges(p, false, line);
+            unique = line == b ? s == 1 : s > 1;
+        }
+        if (unique) return;
+    }
+}
+
+static void gen_day13(Rng *rng, long size, FILE *out) {
+    for (long i = 0; i < size; i++) {
+        Pattern p;
+        random_pattern(rng, &p);
+        bool transpose = rng_chance(rng, 0.5);
+        if (i > 0) fputc('\n', out);
+        for (int y = 0; y < (transpose ? p.cols : p.rows); y++) {
+            for (int x = 0; x < (transpose ? p.rows : p.cols); x++) {
+                fputc((transpose ? p.cell[x][y] : p.cell[y][x]) ? '#' : '.', out);
+            }
+            fputc('\n', out);
+        }
+    }
+}
+
+static void gen_day14(Rng *rng, long size, FILE *out) {
+    static const int weights[] = {20, 5, 75};
+    random_grid(rng, out, size, "O#.", weights);
+}
+
+/* Labels are drawn from a pool which grows with `size`, so that the boxes fill up like in the real input. */
+static void gen_day15(Rng *rng, long size, FILE *out) {
+    long pool = MIN(MAX(16, size / 4), 256 * 256); // at most 256 labels per box on average
+    for (long i = 0; i < size; i++) {
+        u64 label = (u64)rng_range(rng, 0, pool - 1) * 0x9E3779B97F4A7C15ull;
+        int len = 2 + label % 5;
+        char name[8];
+        for (int j = 0; j < len; j++, label /= 26) name[j] = 'a' + (label >> 8) % 26;
+        if (i > 0) fputc(',', out);
+        if (rng_chance(rng, 0.3)) {
+            fprintf(out, "%.*s-", len, name);
+        } else {
+            fprintf(out, "%.*s=%d", len, name, (int)rng_range(rng, 1, 9));
+        }
+    }
+    fputc('\n', out);
+}
+
+static void gen_day16(Rng *rng, long size, FILE *out) {
+    static const int weights[] = {3, 3, 3, 3, 88};
+    random_grid(rng, out, size, "|-/\\.", weights);
+}
+
+static void gen_day17(Rng *rng, long size, FILE *out) {
+    static const int weights[] = {11, 11, 11, 11, 11, 11, 11, 11, 12};
+    random_grid(rng, out, size, "123456789", weights);
+}
+
+/*
+ * The border of a random loop (see random_loop()) with its rows and columns
+ * stretched by random amounts: a little for part 1 and a lot for part 2.
+ */
+static void gen_day18(Rng *rng, long size, FILE *out) {
+    long side = 4 * MAX(2, (long)(1.1 * sqrt(size))) - 1;
+    Cell *loop;
+    long length = random_loop(rng, side, &loop);
+    i64 *small = xcalloc(side + 1, sizeof(i64)), *large = xcalloc(side + 1, sizeof(i64));
+    for (long i = 1; i <= side; i++) {
+        small[i] = small[i - 1] + rng_range(rng, 1, 4);
+        large[i] = large[i - 1] + rng_range(rng, 1, 0xFFFFF / side);
+    }
+
+    static const char dir_name[] = "RDLU";
+    for (long i = 0; i < length;) {
+        Cell from = loop[i];
+        int dir = loop[(i + 1) % length].x > from.x   ? 0
+                  : loop[(i + 1) % length].y > from.y ? 1
+                  : loop[(i + 1) % length].x < from.x ? 2
+                                                      : 3;
+        // follow the loop up to the next corner
+        long j = i + 1;
+        while (j < length) {
+            Cell a = loop[j], b = loop[(j + 1) % length];
+            int d = b.x > a.x ? 0 : b.y > a.y ? 1 : b.x < a.x ? 2 : 3;
+            if (d != dir) break;
+            j++;
+        }
+        Cell to = loop[j % length];
+        bool horizontal = dir % 2 == 0;
+        int a = horizontal ? from.x : from.y, b = horizontal ? to.x : to.y;
+        i64 steps1 = small[MAX(a, b)] - small[MIN(a, b)], steps2 = large[MAX(a, b)] - large[MIN(a, b)];
+        fprintf(out, "%c %ld (#%05lx%d)\n", dir_name[dir], steps1, steps2, dir);
+        i = j;
+    }
+    free(large);
+    free(small);
+    free(loop);
+}
+
+/* A random tree of workflows below "in"; the parts are random. */
+static void gen_day19(Rng *rng, long size, FILE *out) {
+    // names of two or three letters: labels below 26 * 26 are the two letter ones
+    int label_count = 26 * 26 + 26 * 26 * 26, *labels = xcalloc(label_count, sizeof(int));
+    for (int i = 0; i < label_count; i++) labels[i] = i;
+    shuffle(rng, labels, label_count);
+    char(*names)[4] = xcalloc(size, sizeof(*names));
+    strcpy(names[0], "in");
+    for (long i = 1, next = 0; i < size; i++) {
+        int label = labels[next++];
+        if (label < 26 * 26) {
+            snprintf(names[i], sizeof(names[i]), "%c%c", 'a' + label / 26, 'a' + label % 26);
+        } else {
+            label -= 26 * 26;
+            snprintf(names[i], sizeof(names[i]), "%c%c%c", 'a' + label / 676, 'a' + label / 26 % 26, 'a' + label % 26);
+        }
+        if (strcmp(names[i], "in") == 0) i--;
+    }
+
+    // workflows are numbered in BFS order, so each one refers to later ones only
+    for (long i = 0, next = 1; i < size; i++) {
+        int rules = rng_range(rng, 1, 3);
+        fprintf(out, "%s{", names[i]);
+        for (int r = 0; r <= rules; r++) {
+            const char *target;
+            if (next < size && (rng_chance(rng, 0.7) || next <= i + 1)) {
+                target = names[next++];
+            } else {
+                target = rng_chance(rng, 0.5) ? "A" : "R";
+            }
+            if (r < rules) {
+                fprintf(out, "%c%c%d:%s,", rng_pick(rng, "xmas"), rng_pick(rng, "<>"), (int)rng_range(rng, 2, 3999),
+                        target);
+            } else {
+                fprintf(out, "%s}\n", target);
+            }
+        }
+    }
+    fputc('\n', out);
+    long parts = MAX(1, size / 2);
+    for (long i = 0; i < parts; i++) {
+        fprintf(out, "{x=%d,m=%d,a=%d,s=%d}\n", (int)rng_range(rng, 1, 4000), (int)rng_range(rng, 1, 4000),
+                (int)rng_range(rng, 1, 4000), (int)rng_range(rng, 1, 4000));
+    }
+    free(names);
+    free(labels);
+}
+
+static bool is_prime(int n) {
+    for (int d = 2; d * d <= n; d++) {
+        if (n % d == 0) return false;
+    }
+    return n >= 2;
+}
+
+/*
+ * Four binary counters of `size` flip-flops, as in the real input: the
+ * flip-flops which are set in the counter's period p report to a hub, which
+ * resets the counter after p button presses and then sends a high pulse
+ * towards rx. The periods are distinct primes.
+ */
+static void gen_day20(Rng *rng, long size, FILE *out) {
+    int bits = MAX(2, size);
+    int labels[26 * 26], periods[4];
+    int label_count = 0;
+    for (int i = 0; i < 26 * 26; i++) {
+        if (i != ('r' - 'a') * 26 + 'x' - 'a') labels[label_count++] = i;
+    }
+    shuffle(rng, labels, label_count);
+    int next = 0;
+#define NAME(buf) snprintf(buf, sizeof(buf), "%c%c", 'a' + labels[next] / 26, 'a' + labels[next] % 26), next++
+
+    char sink[3], first[4][3];
+    NAME(sink);
+    fprintf(out, "&%s -> rx\n", sink);
+    for (int c = 0; c < 4; c++) {
+        int p;
+        do {
+            p = rng_range(rng, (1 << (bits - 1)) + 1, (1 << bits) - 1);
+            for (int k = 0; k < c && p != 0; k++) p = p == periods[k] ? 0 : p;
+        } while (p == 0 || !is_prime(p) || bits - __builtin_popcount(p) > 6); // hubs have at most 8 outputs
+        periods[c] = p;
+
+        char ff[32][3], hub[3], inverter[3];
+        for (int b = 0; b < bits; b++) NAME(ff[b]);
+        NAME(hub);
+        NAME(inverter);
+        memcpy(first[c], ff[0], 3);
+        for (int b = 0; b < bits; b++) {
+            fprintf(out, "%%%s -> ", ff[b]);
+            bool set = (p >> b) & 1, comma = false;
+            if (b + 1 < bits) fprintf(out, "%s", ff[b + 1]), comma = true;
+            if (set) fprintf(out, "%s%s", comma ? ", " : "", hub);
+            fputc('\n', out);
+        }
+        fprintf(out, "&%s -> %s", hub, inverter);
+        for (int b = 0; b < bits; b++) {
+            if (!((p >> b) & 1) || b == 0) fprintf(out, ", %s", ff[b]);
+        }
+        fprintf(out, "\n&%s -> %s\n", inverter, sink);
+    }
+    fprintf(out, "broadcaster -> %s, %s, %s, %s\n", first[0], first[1], first[2], first[3]);
+#undef NAME
+}
+
+typedef struct {
+    void (*generate)(Rng *rng, long size, FILE *out);
+    const char *unit;  /* meaning of the size */
+    long default_size; /* that of the real input */
+    long max_size;     /* the largest size the solver supports, 0 if unlimited */
+} Generator;
+
+static const Generator generators[] = {
+    {gen_day01, "lines", 1000, 0},
+    {gen_day02, "games", 100, 0},
+    {gen_day03, "grid side", 140, 0},
+    {gen_day04, "cards", 200, 0},
+    {gen_day05, "ranges per map", 25, 32},
+    {gen_day06, "races", 4, 9},
+    {gen_day07, "hands", 1000, 1000},
+    {gen_day08, "nodes", 750, 1024},
+    {gen_day09, "histories", 200, 0},
+    {gen_day10, "grid side", 140, 140},
+    {gen_day11, "grid side", 140, 341},
+    {gen_day12, "rows", 1000, 0},
+    {gen_day13, "patterns", 100, 0},
+    {gen_day14, "grid side", 100, 100},
+    {gen_day15, "steps", 4000, 0},
+    {gen_day16, "grid side", 110, 110},
+    {gen_day17, "grid side", 141, 256},
+    {gen_day18, "instructions (about)", 700, 0},
+    {gen_day19, "workflows", 550, 1024},
+    {gen_day20, "bits per counter", 12, 12},
+};
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [OPTIONS] DAY\n"
+            "       %s --list\n"
+            "\n"
+            "Writes a random, valid input for DAY (e.g. 'day01', '01' or '1') to stdout.\n"
+            "\n"
+            "Options:\n"
+            "  -n, --size N      size of the input (see --list; default: that of the real input)\n"
+            "  -s, --seed N      seed of the random number generator (default: 1)\n"
+            "  -o, --output FILE write to FILE instead of stdout\n"
+            "  -l, --list        list the days and the meaning of their size\n"
+            "  -h, --help        show this help\n",
+            prog, prog);
+}
+
+static void list(void) {
+    printf("%-6s %-22s %8s %8s\n", "day", "size", "default", "max");
+    for (size_t i = 0; i < ARRAY_LENGTH(generators); i++) {
+        const Generator *g = &generators[i];
+        char max[16] = "-";
+        if (g->max_size) snprintf(max, sizeof(max), "%ld", g->max_size);
+        printf("day%02zu  %-22s %8ld %8s\n", i + 1, g->unit, g->default_size, max);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    long size = 0;
+    u64 seed = 1;
+    const char *output = NULL;
+
+    static const struct option options[] = {
+        {"size", required_argument, NULL, 'n'}, {"seed", required_argument, NULL, 's'},
+        {"output", required_argument, NULL, 'o'}, {"list", no_argument, NULL, 'l'},
+        {"help", no_argument, NULL, 'h'},       {NULL, 0, NULL, 0},
+    };
+    int opt;
+    while ((opt = getopt_long(argc, argv, "n:s:o:lh", options, NULL)) != -1) {
+        switch (opt) {
+        case 'n':
+            size = strtol(optarg, NULL, 10);
+            if (size <= 0) {
+                fprintf(stderr, "invalid size: %s\n", optarg);
+                return 1;
+            }
+            break;
+        case 's': seed = strtoull(optarg, NULL, 10); break;
+        case 'o': output = optarg; break;
+        case 'l': list(); return 0;
+        case 'h': usage(argv[0]); return 0;
+        default: usage(argv[0]); return 1;
+        }
+    }
+    if (optind + 1 != argc) {
+        usage(argv[0]);
+        return 1;
+    }
+    const char *day_arg = argv[optind];
+    if (strncmp(day_arg, "day", 3) == 0) day_arg += 3;
+    char *end;
+    long day = strtol(day_arg, &end, 10);
+    if (*end != '\0' || day < 1 || day > (long)ARRAY_LENGTH(generators)) {
+        fprintf(stderr, "no generator for day: %s\n", argv[optind]);
+        return 1;
+    }
+
+    const Generator *g = &generators[day - 1];
+    if (size == 0) size = g->default_size;
+    if (g->max_size && size > g->max_size) {
+        fprintf(stderr, "warning: the day%02ld solver supports at most %ld %s\n", day, g->max_size, g->unit);
+    }
+
+    FILE *out = output ? fopen(output, "w") : stdout;
+    if (out == NULL) {
+        perror(output);
+        return 1;
+    }
+    Rng rng = {.state = seed};
+    g->generate(&rng, size, out);
+    if (fclose(out) != 0) {
+        perror(output ? output : "stdout");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,404 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Runs one, several or all days in-process.
+ *
+ * Inputs are loaded before the clock starts, so the reported times cover
+ * solve() only and not process startup, dynamic linking or file I/O. With
+ * --stream, days which support it read their input chunk by chunk while
+ * solving instead, so reading the file is part of the measurement.
+ *
+ * With --parallel, all days run concurrently on a thread pool. The longest
+ * day (the critical path) is a lower bound for the wall time of the suite.
+ *
+ * With --perf, hardware performance counters are read around every solve()
+ * to explain the times: IPC, branch mispredictions and cache misses.
+ *
+ * With --serve, the runner becomes a daemon which answers solve requests on a
+ * Unix domain socket (see serve.h and aoc-client).
+ *
+ * With --cache, solutions are looked up by the hash of the input in a cache
+ * file first and only solved on a miss. The solver version of a day, a hash
+ * of its sources, is part of the key, so changing a day invalidates its
+ * entries.
+ *
+ * Builds configured with -Dmemstats=true count the heap allocations and
+ * measure the peak heap and stack usage of every solve() (see memstats.h).
+ * This slows down every run by painting the stack first.
+ */
+
+#include <getopt.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "aoc/io.h"
+#include "aoc/macros.h"
+#include "aoc/pool.h"
+#include "aoc/time.h"
+#include "cache.h"
+#include "days.h"
+#ifdef AOC_MEMSTATS
+#include "memstats.h"
+#endif
+#include "perf.h"
+#include "runner.h"
+#include "serve.h"
+#include "stats.h"
+
+#define MAX_DAYS 64
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [OPTIONS] [DAY...]\n"
+            "\n"
+            "Runs the given days (e.g. 'day01', '01' or '1'), or all days if none are given.\n"
+            "\n"
+            "Options:\n"
+            "  -b, --bench N      run every day N times and report min/median/max\n"
+            "  -c, --cache[=FILE] look up the solutions in a result cache (default:\n"
+            "                     ~/.cache/aoc-2023/results) and store them on a miss;\n"
+            "                     not with --stream\n"
+            "  -i, --input FILE   read the input of the (single) given day from FILE\n"
+            "  -p, --parallel[=N] run the days concurrently on N threads (default: one per CPU),\n"
+            "                     longest first, and report wall time, critical path and CPU time\n"
+            "  -P, --perf         count cycles, instructions, branch and cache misses of every day\n"
+            "                     and report IPC and miss rates (requires perf_event_open access)\n"
+            "  -S, --serve SOCKET serve solve requests on the Unix domain socket SOCKET until\n"
+            "                     interrupted, on N threads with --parallel=N\n"
+            "  -s, --stream       stream the input in chunks instead of loading it as a whole\n"
+            "                     (only line-oriented days; includes the time to read the input)\n"
+            "  -h, --help         show this help\n",
+            prog);
+}
+
+#ifdef AOC_TIMING
+/* Prints the mean duration of each phase; whatever was not instrumented is reported as 'other'. */
+static void print_phases(const SolveTiming *timing, u64 mean, int repetitions) {
+    u64 parse = timing->parse_ns / repetitions, part1 = timing->part1_ns / repetitions,
+        part2 = timing->part2_ns / repetitions;
+    u64 phases = parse + part1 + part2;
+    u64 other = mean > phases ? mean - phases : 0;
+
+    char t_parse[32], t_part1[32], t_part2[32], t_other[32];
+    aoc_format_duration(parse, t_parse, sizeof(t_parse));
+    aoc_format_duration(part1, t_part1, sizeof(t_part1));
+    aoc_format_duration(part2, t_part2, sizeof(t_part2));
+    aoc_format_duration(other, t_other, sizeof(t_other));
+    printf("       parse %s, part1 %s, part2 %s, other %s\n", t_parse, t_part1, t_part2, t_other);
+}
+#endif
+
+/* Prints the counts per repetition, unless no counter could be opened. */
+static void print_counts(const AocPerfCounts *counts, int repetitions) {
+    AocPerfCounts mean = *counts;
+    bool any = false;
+    for (int i = 0; i < AOC_PERF_EVENT_COUNT; i++) {
+        mean.value[i] /= repetitions;
+        any |= mean.valid[i];
+    }
+    if (!any) return;
+    char line[256];
+    aoc_perf_format(&mean, line, sizeof(line));
+    printf("       %s\n", line);
+}
+
+#ifdef AOC_MEMSTATS
+/* Prints the allocations per repetition and the peaks of all repetitions. */
+static void print_memstats(const AocMemStats *stats, int repetitions) {
+    char bytes[32], peak_heap[32], peak_stack[32];
+    aoc_format_bytes(stats->bytes / repetitions, bytes, sizeof(bytes));
+    aoc_format_bytes(stats->peak_heap, peak_heap, sizeof(peak_heap));
+    aoc_format_bytes(stats->peak_stack, peak_stack, sizeof(peak_stack));
+    printf("       heap: %lu allocations (%s), %lu frees, peak %s; stack: peak %s\n", stats->allocations / repetitions,
+           bytes, stats->frees / repetitions, peak_heap, peak_stack);
+}
+#endif
+
+/* Solves `day` by streaming `fname` through solve_stream(), i.e. including the time to read the file. */
+static int stream_day(const AocDay *day, const char *fname, Solution *solution) {
+    _cleanup_(aoc_stream_close) AocStream *stream = aoc_stream_open(fname, AOC_STREAM_CHUNK_SIZE);
+    if (stream == NULL) return -1;
+    return day->solve_stream(stream, solution);
+}
+
+typedef struct {
+    const AocDay *day;
+    const char *input_path; /* NULL for the default input */
+    int repetitions;
+    bool stream;
+    bool perf;
+    AocCache *cache; /* NULL unless --cache */
+
+    int rc;
+    bool cached; /* the solution was taken from the cache */
+    Solution solution;
+    AocStats stats;
+    u64 busy_ns;          /* sum of all repetitions */
+    AocPerfCounts counts; /* sum of all repetitions */
+#ifdef AOC_TIMING
+    SolveTiming timing;
+#endif
+#ifdef AOC_MEMSTATS
+    AocMemStats memstats;
+#endif
+} DayRun;
+
+static int run_day(DayRun *run) {
+    const AocDay *day = run->day;
+    char fname[256];
+    if (run->input_path != NULL) {
+        snprintf(fname, sizeof(fname), "%s", run->input_path);
+    } else {
+        aoc_day_input_path(day, NULL, fname, sizeof(fname));
+    }
+
+    bool stream = run->stream;
+    if (stream && day->solve_stream == NULL) {
+        fprintf(stderr, "%s: streaming is not supported, loading the whole input\n", day->name);
+        stream = false;
+    }
+    AocInput input = {0};
+    if (!stream && aoc_io_map_input(fname, &input)) {
+        fprintf(stderr, "%s: failed to read %s\n", day->name, fname);
+        return -1;
+    }
+
+    XXH128_hash_t input_hash = {0};
+    if (run->cache && !stream) {
+        input_hash = XXH3_128bits(input.buf, input.size);
+        if (aoc_cache_lookup(run->cache, day->name, day->version, input_hash, &run->solution)) {
+            run->cached = true;
+            aoc_io_unmap_input(&input);
+            return 0;
+        }
+    }
+
+    // counters are per thread, so they are opened by the thread running the day
+    _cleanup_(aoc_perf_close) AocPerf *perf = run->perf ? aoc_perf_open() : NULL;
+    u64 *samples = malloc(run->repetitions * sizeof(u64));
+    if (samples == NULL) {
+        fprintf(stderr, "%s: out of memory\n", day->name);
+        abort();
+    }
+    run->busy_ns = 0;
+    for (int i = 0; i < run->repetitions; i++) {
+        run->solution = (Solution){0};
+#ifdef AOC_MEMSTATS
+        aoc_memstats_start();
+#endif
+        if (perf) aoc_perf_start(perf);
+        u64 start = aoc_time_now_ns();
+        if (!stream) {
+            day->solve(input.buf, input.size, &run->solution);
+        } else if (stream_day(day, fname, &run->solution)) {
+            fprintf(stderr, "%s: failed to read %s\n", day->name, fname);
+            free(samples);
+            return -1;
+        }
+        samples[i] = aoc_time_now_ns() - start;
+        if (perf) aoc_perf_stop(perf, &run->counts);
+#ifdef AOC_MEMSTATS
+        aoc_memstats_stop(&run->memstats);
+#endif
+        run->busy_ns += samples[i];
+#ifdef AOC_TIMING
+        run->timing.parse_ns += run->solution.timing.parse_ns;
+        run->timing.part1_ns += run->solution.timing.part1_ns;
+        run->timing.part2_ns += run->solution.timing.part2_ns;
+#endif
+    }
+    aoc_io_unmap_input(&input);
+    if (run->cache && !stream) aoc_cache_store(run->cache, day->name, day->version, input_hash, &run->solution);
+
+    aoc_stats_compute(samples, run->repetitions, &run->stats);
+    free(samples);
+    return 0;
+}
+
+static void print_day(const DayRun *run) {
+    const AocStats *stats = &run->stats;
+    char t_min[32], t_median[32], t_max[32];
+    aoc_format_duration(stats->min, t_min, sizeof(t_min));
+    printf("%s  Part1: %-16s Part2: %-16s ", run->day->name, run->solution.part1, run->solution.part2);
+    if (run->cached) {
+        printf("(cached)\n");
+        return;
+    }
+    if (run->repetitions == 1) {
+        printf("(%s)\n", t_min);
+    } else {
+        aoc_format_duration(stats->median, t_median, sizeof(t_median));
+        aoc_format_duration(stats->max, t_max, sizeof(t_max));
+        printf("(min %s, median %s, max %s, %d runs)\n", t_min, t_median, t_max, run->repetitions);
+    }
+#ifdef AOC_TIMING
+    print_phases(&run->timing, stats->mean, run->repetitions);
+#endif
+    if (run->perf) print_counts(&run->counts, run->repetitions);
+#ifdef AOC_MEMSTATS
+    print_memstats(&run->memstats, run->repetitions);
+#endif
+}
+
+static void run_day_task(void *arg, int _unused_ worker) {
+    DayRun *run = arg;
+    run->rc = run_day(run);
+}
+
+/*
+ * Longest processing time first: hand the days, in order of decreasing
+ * expected cost, to the worker with the least expected load so far. Workers
+ * run their own tasks LIFO, so every worker's days are submitted shortest
+ * first; an idle worker steals the shortest pending day of another.
+ */
+static void schedule_lpt(AocPool *pool, DayRun runs[], int count) {
+    int order[MAX_DAYS], assigned[MAX_DAYS];
+    for (int i = 0; i < count; i++) {
+        int j = i;
+        u64 cost = aoc_day_expected_ns(runs[i].day);
+        for (; j > 0 && aoc_day_expected_ns(runs[order[j - 1]].day) < cost; j--) order[j] = order[j - 1];
+        order[j] = i;
+    }
+
+    int workers = aoc_pool_size(pool);
+    u64 *load = calloc(workers, sizeof(u64));
+    for (int i = 0; i < count; i++) {
+        int best = 0;
+        for (int w = 1; w < workers; w++) {
+            if (load[w] < load[best]) best = w;
+        }
+        load[best] += aoc_day_expected_ns(runs[order[i]].day) * runs[order[i]].repetitions;
+        assigned[order[i]] = best;
+    }
+    free(load);
+
+    for (int i = count - 1; i >= 0; i--) aoc_pool_submit_to(pool, assigned[order[i]], run_day_task, &runs[order[i]]);
+}
+
+static int run_parallel(DayRun runs[], int count, int jobs) {
+    _cleanup_(aoc_pool_destroy) AocPool *pool = aoc_pool_create(jobs);
+    if (pool == NULL) return 1;
+
+    u64 start = aoc_time_now_ns();
+    schedule_lpt(pool, runs, count);
+    aoc_pool_wait(pool);
+    u64 wall = aoc_time_now_ns() - start;
+
+    int rc = 0;
+    u64 cpu = 0;
+    const DayRun *critical = NULL;
+    for (int i = 0; i < count; i++) {
+        if (runs[i].rc) {
+            rc = 1;
+            continue;
+        }
+        print_day(&runs[i]);
+        cpu += runs[i].busy_ns;
+        if (critical == NULL || runs[i].busy_ns > critical->busy_ns) critical = &runs[i];
+    }
+    if (critical == NULL) return rc;
+
+    char t_wall[32], t_critical[32], t_cpu[32];
+    aoc_format_duration(wall, t_wall, sizeof(t_wall));
+    aoc_format_duration(critical->busy_ns, t_critical, sizeof(t_critical));
+    aoc_format_duration(cpu, t_cpu, sizeof(t_cpu));
+    printf("wall: %s, critical path: %s (%s), cpu: %s, %d threads\n", t_wall, t_critical, critical->day->name, t_cpu,
+           aoc_pool_size(pool));
+    return rc;
+}
+
+int main(int argc, char *argv[]) {
+    int repetitions = 1, jobs = -1;
+    bool stream = false, perf = false;
+    const char *input_path = NULL, *cache_path = NULL, *socket_path = NULL;
+    bool use_cache = false;
+
+    static const struct option options[] = {
+        {"bench", required_argument, NULL, 'b'},
+        {"cache", optional_argument, NULL, 'c'},
+        {"input", required_argument, NULL, 'i'},
+        {"parallel", optional_argument, NULL, 'p'},
+        {"perf", no_argument, NULL, 'P'},
+        {"serve", required_argument, NULL, 'S'},
+        {"stream", no_argument, NULL, 's'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0},
+    };
+    int opt;
+    while ((opt = getopt_long(argc, argv, "b:c::i:p::PS:sh", options, NULL)) != -1) {
+        switch (opt) {
+        case 'b':
+            repetitions = atoi(optarg);
+            if (repetitions <= 0) {
+                fprintf(stderr, "invalid number of repetitions: %s\n", optarg);
+                return 1;
+            }
+            break;
+        case 'c':
+            use_cache = true;
+            cache_path = optarg;
+            break;
+        case 'i': input_path = optarg; break;
+        case 'p': jobs = optarg != NULL ? atoi(optarg) : 0; break;
+        case 'P': perf = true; break;
+        case 'S': socket_path = optarg; break;
+        case 's': stream = true; break;
+        case 'h': usage(argv[0]); return 0;
+        default: usage(argv[0]); return 1;
+        }
+    }
+
+    if (socket_path != NULL) return aoc_serve(socket_path, jobs) ? 1 : 0;
+
+    const AocDay *selected[MAX_DAYS];
+    int selected_count = aoc_days_select(&argv[optind], argc - optind, selected, ARRAY_LENGTH(selected));
+    if (selected_count < 0) return 1;
+    if (input_path != NULL && selected_count != 1) {
+        fprintf(stderr, "--input requires exactly one day\n");
+        return 1;
+    }
+
+    _cleanup_(aoc_cache_close) AocCache *cache = NULL;
+    if (use_cache) {
+        char default_path[4096];
+        if (cache_path == NULL) {
+            if (aoc_cache_default_path(default_path, sizeof(default_path))) {
+                fprintf(stderr, "cache: no cache directory, use --cache=FILE\n");
+                return 1;
+            }
+            cache_path = default_path;
+        }
+        if ((cache = aoc_cache_open(cache_path)) == NULL) return 1;
+    }
+
+    DayRun runs[MAX_DAYS];
+    for (int i = 0; i < selected_count; i++) {
+        runs[i] = (DayRun){.day = selected[i], .input_path = input_path, .repetitions = repetitions, .stream = stream,
+                          .perf = perf, .cache = cache};
+    }
+    if (jobs >= 0) return run_parallel(runs, selected_count, jobs);
+
+    int rc = 0;
+    u64 total = 0;
+    for (int i = 0; i < selected_count; i++) {
+        if (run_day(&runs[i])) {
+            rc = 1;
+            continue;
+        }
+        print_day(&runs[i]);
+        total += runs[i].stats.median;
+    }
+    if (selected_count > 1) {
+        char t_total[32];
+        aoc_format_duration(total, t_total, sizeof(t_total));
+        printf("total: %s\n", t_total);
+    }
+    return rc;
+}
@@ -0,0 +1,231 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Lookup throughput of the flat hash set (aoc/fmap.h) versus the chained
+ * CTL set (ust.h).
+ *
+ * The keys are taken from the real inputs: the search states of day 17 and
+ * the workflow and module names of days 19 and 20. Every key is looked up
+ * once as a hit and once as a miss per round.
+ */
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <xxhash.h>
+
+#include "aoc/io.h"
+#include "aoc/macros.h"
+#include "aoc/time.h"
+
+typedef struct {
+    const char *ptr;
+    size_t len;
+} Name;
+
+typedef struct {
+    int x, y, direction, count;
+} Node;
+
+static size_t Name_hash(Name *name) { return XXH3_64bits(name->ptr, name->len); }
+static int Name_equal(Name *lhs, Name *rhs) {
+    return lhs->len == rhs->len && memcmp(lhs->ptr, rhs->ptr, lhs->len) == 0;
+}
+
+/* same as day 17 */
+static size_t Node_hash(Node *node) {
+    const size_t prime = 31;
+    size_t hash = 17;
+    hash = hash * prime + (size_t)node->x;
+    hash = hash * prime + (size_t)node->y;
+    hash = hash * prime + (size_t)node->direction;
+    hash = hash * prime + (size_t)node->count;
+    return hash;
+}
+static int Node_equal(Node *lhs, Node *rhs) {
+    return lhs->x == rhs->x && lhs->y == rhs->y && lhs->direction == rhs->direction && lhs->count == rhs->count;
+}
+
+#define P
+#define T Name
+#include <ust.h>
+
+#define P
+#define T Name
+#include "aoc/fmap.h"
+
+#define P
+#define T Node
+#include <ust.h>
+
+#define P
+#define T Node
+#include "aoc/fmap.h"
+
+#define TARGET_LOOKUPS 20000000
+
+typedef struct {
+    double insert; // million inserts per second
+    double lookup; // million lookups per second
+} Rate;
+
+#define MEASURE(A, hash, equal, keys, misses, count, rounds)                                                           \
+    ({                                                                                                                 \
+        A map = JOIN(A, init)(hash, equal);                                                                            \
+        u64 start = aoc_time_now_ns();                                                                                 \
+        for (size_t i = 0; i < (count); i++) JOIN(A, insert)(&map, (keys)[i]);                                         \
+        u64 inserted = aoc_time_now_ns();                                                                              \
+        size_t found = 0;                                                                                              \
+        for (int r = 0; r < (rounds); r++) {                                                                           \
+            for (size_t i = 0; i < (count); i++) {                                                                     \
+                found += JOIN(A, find)(&map, (keys)[i]) != NULL;                                                       \
+                found += JOIN(A, find)(&map, (misses)[i]) != NULL;                                                     \
+            }                                                                                                          \
+        }                                                                                                              \
+        u64 done = aoc_time_now_ns();                                                                                  \
+        JOIN(A, free)(&map);                                                                                           \
+        if (found != (size_t)(rounds) * (count)) {                                                                     \
+            fprintf(stderr, #A ": found %zu of %zu keys\n", found, (size_t)(rounds) * (count));                        \
+            exit(1);                                                                                                   \
+        }                                                                                                              \
+        (Rate){.insert = (count) / ((inserted - start) / 1e3),                                                         \
+               .lookup = 2.0 * (rounds) * (count) / ((done - inserted) / 1e3)};                                        \
+    })
+
+static void print_rates(const char *workload, size_t count, Rate ust, Rate fmap) {
+    printf("%-18s %8zu %10.1f %10.1f %10.1f %10.1f %7.2fx\n", workload, count, ust.insert, fmap.insert, ust.lookup,
+           fmap.lookup, fmap.lookup / ust.lookup);
+}
+
+/* Fisher-Yates with a fixed seed: the solvers do not look up their keys in hash order either. */
+static void shuffle(void *items, size_t count, size_t size) {
+    char tmp[64];
+    u64 state = 0x2545F4914F6CDD1Dull;
+    for (size_t i = count; i > 1; i--) {
+        state ^= state << 13, state ^= state >> 7, state ^= state << 17;
+        size_t j = state % i;
+        memcpy(tmp, (char *)items + (i - 1) * size, size);
+        memcpy((char *)items + (i - 1) * size, (char *)items + j * size, size);
+        memcpy((char *)items + j * size, tmp, size);
+    }
+}
+
+static int rounds_for(size_t count) { return MAX(1, (int)(TARGET_LOOKUPS / 2 / MAX(count, (size_t)1))); }
+
+/* All states (position, direction, straight moves so far) of the day 17 crucible search. */
+static void bench_day17(const char *fname) {
+    _cleanup_(aoc_io_unmap_input) AocInput input;
+    if (aoc_io_map_input(fname, &input)) {
+        fprintf(stderr, "Skipping day17: failed to read %s\n", fname);
+        return;
+    }
+    int cols = strcspn(input.buf, "\n"), rows = 0;
+    for (size_t i = 0; i < input.size; i++) rows += input.buf[i] == '\n';
+
+    size_t count = (size_t)rows * cols * 4 * 10;
+    Node *keys = malloc(count * sizeof(Node)), *misses = malloc(count * sizeof(Node));
+    size_t n = 0;
+    for (int y = 0; y < rows; y++) {
+        for (int x = 0; x < cols; x++) {
+            for (int direction = 0; direction < 4; direction++) {
+                for (int c = 1; c <= 10; c++) {
+                    misses[n] = (Node){.x = x, .y = y, .direction = direction, .count = 10 + c};
+                    keys[n++] = (Node){.x = x, .y = y, .direction = direction, .count = c};
+                }
+            }
+        }
+    }
+
+    shuffle(keys, count, sizeof(Node));
+    shuffle(misses, count, sizeof(Node));
+    int rounds = rounds_for(count);
+    Rate ust = MEASURE(ust_Node, Node_hash, Node_equal, keys, misses, count, rounds);
+    Rate fmap = MEASURE(fmap_Node, Node_hash, Node_equal, keys, misses, count, rounds);
+    print_rates("day17 states", count, ust, fmap);
+    free(keys);
+    free(misses);
+}
+
+/* The names in front of `delim` at the beginning of each line, up to the first empty line. */
+static size_t collect_names(const AocInput *input, const char *skip, char delim, Name *names, size_t capacity) {
+    size_t count = 0;
+    for (size_t pos = 0; pos < input->size && input->buf[pos] != '\n' && count < capacity;) {
+        if (strchr(skip, input->buf[pos])) pos++;
+        size_t len = 0;
+        while (pos + len < input->size && input->buf[pos + len] != delim) len++;
+        names[count++] = (Name){.ptr = &input->buf[pos], .len = len};
+        while (pos < input->size && input->buf[pos] != '\n') pos++;
+        pos++;
+    }
+    return count;
+}
+
+static void bench_names(const char *workload, const char *fname, const char *skip, char delim) {
+    _cleanup_(aoc_io_unmap_input) AocInput input;
+    if (aoc_io_map_input(fname, &input)) {
+        fprintf(stderr, "Skipping %s: failed to read %s\n", workload, fname);
+        return;
+    }
+    size_t capacity = input.size / 2 + 1;
+    Name *keys = malloc(capacity * sizeof(Name)), *misses = malloc(capacity * sizeof(Name));
+    size_t count = collect_names(&input, skip, delim, keys, capacity);
+
+    // names never contain a '~'
+    char *miss_names = malloc(count * 8);
+    for (size_t i = 0; i < count; i++) {
+        int len = snprintf(&miss_names[8 * i], 8, "~%zu", i % 1000000);
+        misses[i] = (Name){.ptr = &miss_names[8 * i], .len = len};
+    }
+
+    shuffle(keys, count, sizeof(Name));
+    int rounds = rounds_for(count);
+    Rate ust = MEASURE(ust_Name, Name_hash, Name_equal, keys, misses, count, rounds);
+    Rate fmap = MEASURE(fmap_Name, Name_hash, Name_equal, keys, misses, count, rounds);
+    print_rates(workload, count, ust, fmap);
+    free(miss_names);
+    free(keys);
+    free(misses);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [INPUT_DIR]\n"
+            "\n"
+            "Compares insert and lookup throughput (in million operations per second) of\n"
+            "the flat hash set and ust, using keys from the inputs in INPUT_DIR (default: input).\n",
+            prog);
+}
+
+int main(int argc, char *argv[]) {
+    static const struct option options[] = {
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0},
+    };
+    int opt;
+    while ((opt = getopt_long(argc, argv, "h", options, NULL)) != -1) {
+        switch (opt) {
+        case 'h': usage(argv[0]); return 0;
+        default: usage(argv[0]); return 1;
+        }
+    }
+    const char *dir = optind < argc ? argv[optind] : "input";
+
+    char fname[4096];
+    printf("%-18s %8s %10s %10s %10s %10s %8s\n", "workload", "keys", "ust ins", "fmap ins", "ust find", "fmap find",
+           "speedup");
+    snprintf(fname, sizeof(fname), "%s/day17.txt", dir);
+    bench_day17(fname);
+    snprintf(fname, sizeof(fname), "%s/day19.txt", dir);
+    bench_names("day19 workflows", fname, "", '{');
+    snprintf(fname, sizeof(fname), "%s/day20.txt", dir);
+    bench_names("day20 modules", fname, "%&", ' ');
+    return 0;
+}
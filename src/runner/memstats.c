@@ -0,0 +1,123 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * The heap is accounted in wrappers of the allocation functions (see ld's
+ * --wrap), by the usable size of each block. The stack high-water mark is
+ * found by painting the unused part of the stack with a pattern and looking
+ * for the deepest byte which was overwritten.
+ */
+
+#include <malloc.h>
+#include <pthread.h>
+#include <stdint.h>
+
+#include "aoc/macros.h"
+#include "memstats.h"
+
+#define STACK_PATTERN 0xA5A5A5A5A5A5A5A5ull
+#define STACK_MAX_PAINT (8 << 20) /* bytes */
+#define STACK_GUARD (64 << 10)    /* bytes left unpainted at the end of the stack */
+#define STACK_RED_ZONE 256        /* bytes left unpainted below the frame of paint_stack() */
+
+typedef struct {
+    i64 live; /* may become negative if this thread frees memory of another one */
+    i64 base; /* `live` at aoc_memstats_start() */
+    i64 peak;
+    u64 allocations, frees, bytes;
+    char *stack_bottom;       /* lowest address of the stack, NULL if not known yet */
+    u64 *paint_lo, *paint_hi; /* painted range of the stack */
+} ThreadStats;
+
+static _Thread_local ThreadStats thread_stats;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void __real_free(void *ptr);
+
+static inline void account_alloc(void *ptr) {
+    ThreadStats *s = &thread_stats;
+    size_t size = malloc_usable_size(ptr);
+    s->allocations++;
+    s->bytes += size;
+    s->live += size;
+    if (s->live > s->peak) s->peak = s->live;
+}
+
+void *__wrap_malloc(size_t size) {
+    void *ptr = __real_malloc(size);
+    if (ptr) account_alloc(ptr);
+    return ptr;
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+    void *ptr = __real_calloc(count, size);
+    if (ptr) account_alloc(ptr);
+    return ptr;
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    size_t old_size = ptr ? malloc_usable_size(ptr) : 0;
+    void *result = __real_realloc(ptr, size);
+    if (result) {
+        thread_stats.live -= old_size;
+        account_alloc(result);
+    }
+    return result;
+}
+
+void __wrap_free(void *ptr) {
+    if (ptr) {
+        thread_stats.frees++;
+        thread_stats.live -= malloc_usable_size(ptr);
+    }
+    __real_free(ptr);
+}
+
+/* Lowest address of the stack of the calling thread, or NULL on error. */
+static char *find_stack_bottom(void) {
+    pthread_attr_t attr;
+    void *addr = NULL;
+    size_t size;
+    if (pthread_getattr_np(pthread_self(), &attr) != 0) return NULL;
+    if (pthread_attr_getstack(&attr, &addr, &size) != 0) addr = NULL;
+    pthread_attr_destroy(&attr);
+    return addr;
+}
+
+/* Paints the unused stack below this function, which must not call any other function. */
+static __attribute__((noinline)) void paint_stack(ThreadStats *s, char *bottom) {
+    char *top = (char *)__builtin_frame_address(0) - STACK_RED_ZONE;
+    char *lo = MAX(bottom + STACK_GUARD, top - STACK_MAX_PAINT);
+    s->paint_lo = (u64 *)(((uintptr_t)lo + 7) & ~(uintptr_t)7);
+    s->paint_hi = (u64 *)((uintptr_t)top & ~(uintptr_t)7);
+    for (volatile u64 *p = s->paint_lo; p < s->paint_hi; p++) *p = STACK_PATTERN;
+}
+
+void aoc_memstats_start(void) {
+    ThreadStats *s = &thread_stats;
+    s->base = s->peak = s->live;
+    s->allocations = s->frees = s->bytes = 0;
+    s->paint_lo = s->paint_hi = NULL;
+    // for the main thread, glibc parses /proc/self/maps
+    if (s->stack_bottom == NULL) s->stack_bottom = find_stack_bottom();
+    if (s->stack_bottom) paint_stack(s, s->stack_bottom);
+}
+
+void aoc_memstats_stop(AocMemStats *stats) {
+    ThreadStats *s = &thread_stats;
+    const u64 *p = s->paint_lo;
+    while (p < s->paint_hi && *p == STACK_PATTERN) p++;
+    u64 peak_stack = (const char *)s->paint_hi - (const char *)p;
+    stats->allocations += s->allocations;
+    stats->frees += s->frees;
+    stats->bytes += s->bytes;
+    stats->peak_heap = MAX(stats->peak_heap, (u64)(s->peak - s->base));
+    stats->peak_stack = MAX(stats->peak_stack, peak_stack);
+}
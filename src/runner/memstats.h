@@ -0,0 +1,39 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#include "aoc/types.h"
+
+/*
+ * Heap and stack usage of the calling thread, available in builds configured
+ * with -Dmemstats=true (AOC_MEMSTATS). The runner is then linked with
+ * --wrap=malloc, --wrap=calloc, --wrap=realloc and --wrap=free, so every
+ * allocation of the solvers, the CTL containers and the arenas is counted.
+ * Memory allocated inside libc (e.g. by strdup) is not.
+ */
+typedef struct {
+    u64 allocations; /* calls of malloc, calloc and realloc */
+    u64 frees;
+    u64 bytes;      /* sum of all allocation sizes */
+    u64 peak_heap;  /* high-water mark of the live heap, relative to aoc_memstats_start() */
+    u64 peak_stack; /* high-water mark of the stack below the caller of aoc_memstats_start() */
+} AocMemStats;
+
+/**
+ * Starts measuring the calling thread. The caller must call
+ * aoc_memstats_stop() from the same function, i.e. at the same stack depth.
+ */
+void aoc_memstats_start(void);
+
+/**
+ * Stops measuring, adds the counts to `stats` and raises its peaks.
+ */
+void aoc_memstats_stop(AocMemStats *stats);
@@ -0,0 +1,175 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "aoc/macros.h"
+#include "perf.h"
+
+struct AocPerf {
+    int fd[AOC_PERF_EVENT_COUNT]; /* -1 if the event is not available */
+};
+
+static void warn_once(const char *reason) {
+    static int warned;
+    if (__atomic_exchange_n(&warned, 1, __ATOMIC_RELAXED)) return;
+    fprintf(stderr, "perf: hardware counters unavailable: %s\n", reason);
+}
+
+#ifdef __linux__
+typedef struct {
+    u32 type;
+    u64 config;
+} EventConfig;
+
+#define HW_CACHE(cache, op, result)                                                                                    \
+    ((PERF_COUNT_HW_CACHE_##cache) | (PERF_COUNT_HW_CACHE_OP_##op << 8) | (PERF_COUNT_HW_CACHE_RESULT_##result << 16))
+
+static const EventConfig events[AOC_PERF_EVENT_COUNT] = {
+    [AOC_PERF_CYCLES] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    [AOC_PERF_INSTRUCTIONS] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    [AOC_PERF_BRANCHES] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS},
+    [AOC_PERF_BRANCH_MISSES] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    [AOC_PERF_L1D_MISSES] = {PERF_TYPE_HW_CACHE, HW_CACHE(L1D, READ, MISS)},
+    [AOC_PERF_LLC_MISSES] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+};
+
+static int open_event(const EventConfig *event) {
+    struct perf_event_attr attr = {
+        .size = sizeof(attr),
+        .type = event->type,
+        .config = event->config,
+        .disabled = 1,
+        .exclude_kernel = 1,
+        .exclude_hv = 1,
+        .read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING,
+    };
+    // this thread, any CPU; every event is its own group so that unsupported ones can be skipped
+    return syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+AocPerf *aoc_perf_open(void) {
+    AocPerf *perf = malloc(sizeof(*perf));
+    if (perf == NULL) return NULL;
+    int opened = 0, error = 0;
+    for (int i = 0; i < AOC_PERF_EVENT_COUNT; i++) {
+        perf->fd[i] = open_event(&events[i]);
+        if (perf->fd[i] >= 0) {
+            opened++;
+        } else if (error == 0) {
+            error = errno;
+        }
+    }
+    if (opened == 0) {
+        char reason[256];
+        if (error == EACCES || error == EPERM) {
+            snprintf(reason, sizeof(reason), "%s (check /proc/sys/kernel/perf_event_paranoid)", strerror(error));
+        } else {
+            snprintf(reason, sizeof(reason), "%s", strerror(error));
+        }
+        warn_once(reason);
+        free(perf);
+        return NULL;
+    }
+    return perf;
+}
+
+void aoc_perf_close(AocPerf **perf) {
+    AocPerf *p = *perf;
+    if (p == NULL) return;
+    for (int i = 0; i < AOC_PERF_EVENT_COUNT; i++) {
+        if (p->fd[i] >= 0) close(p->fd[i]);
+    }
+    free(p);
+    *perf = NULL;
+}
+
+void aoc_perf_start(AocPerf *perf) {
+    for (int i = 0; i < AOC_PERF_EVENT_COUNT; i++) {
+        if (perf->fd[i] < 0) continue;
+        ioctl(perf->fd[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(perf->fd[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+void aoc_perf_stop(AocPerf *perf, AocPerfCounts *counts) {
+    for (int i = 0; i < AOC_PERF_EVENT_COUNT; i++) {
+        if (perf->fd[i] >= 0) ioctl(perf->fd[i], PERF_EVENT_IOC_DISABLE, 0);
+    }
+    for (int i = 0; i < AOC_PERF_EVENT_COUNT; i++) {
+        if (perf->fd[i] < 0) continue;
+        struct {
+            u64 value, time_enabled, time_running;
+        } data;
+        if (read(perf->fd[i], &data, sizeof(data)) != sizeof(data) || data.time_running == 0) continue;
+        u64 value = data.value;
+        if (data.time_running < data.time_enabled) value = (double)value * data.time_enabled / data.time_running;
+        counts->value[i] += value;
+        counts->valid[i] = true;
+    }
+}
+#else
+AocPerf *aoc_perf_open(void) {
+    warn_once("not supported on this platform");
+    return NULL;
+}
+
+void aoc_perf_close(AocPerf **perf) { *perf = NULL; }
+void aoc_perf_start(AocPerf *_unused_ perf) {}
+void aoc_perf_stop(AocPerf *_unused_ perf, AocPerfCounts *_unused_ counts) {}
+#endif
+
+/* Appends to `out` like snprintf(), keeping track of the used length. */
+#define APPEND(out, out_size, len, ...)                                                                                \
+    do {                                                                                                               \
+        if ((len) < (out_size)) (len) += snprintf((out) + (len), (out_size) - (len), __VA_ARGS__);                     \
+    } while (0)
+
+void aoc_perf_format(const AocPerfCounts *counts, char *out, size_t out_size) {
+    const u64 *v = counts->value;
+    const bool *valid = counts->valid;
+    size_t len = 0;
+    out[0] = '\0';
+
+    if (valid[AOC_PERF_CYCLES]) {
+        u64 cycles = v[AOC_PERF_CYCLES];
+        if (cycles >= 1000000000) {
+            APPEND(out, out_size, len, "%.2f G cycles", cycles / 1e9);
+        } else {
+            APPEND(out, out_size, len, "%.2f M cycles", cycles / 1e6);
+        }
+    }
+    if (valid[AOC_PERF_INSTRUCTIONS] && valid[AOC_PERF_CYCLES] && v[AOC_PERF_CYCLES] > 0) {
+        APPEND(out, out_size, len, ", IPC %.2f", (double)v[AOC_PERF_INSTRUCTIONS] / v[AOC_PERF_CYCLES]);
+    }
+    if (valid[AOC_PERF_BRANCH_MISSES] && valid[AOC_PERF_BRANCHES] && v[AOC_PERF_BRANCHES] > 0) {
+        APPEND(out, out_size, len, ", branch misses %.2f%%",
+               100.0 * v[AOC_PERF_BRANCH_MISSES] / v[AOC_PERF_BRANCHES]);
+    }
+    if (valid[AOC_PERF_INSTRUCTIONS] && v[AOC_PERF_INSTRUCTIONS] > 0) {
+        double kilo_instructions = v[AOC_PERF_INSTRUCTIONS] / 1e3;
+        if (valid[AOC_PERF_L1D_MISSES]) {
+            APPEND(out, out_size, len, ", L1d MPKI %.2f", v[AOC_PERF_L1D_MISSES] / kilo_instructions);
+        }
+        if (valid[AOC_PERF_LLC_MISSES]) {
+            APPEND(out, out_size, len, ", LLC MPKI %.2f", v[AOC_PERF_LLC_MISSES] / kilo_instructions);
+        }
+    }
+    if (len == 0) snprintf(out, out_size, "no counters");
+    if (out[0] == ',') memmove(out, out + 2, strlen(out + 2) + 1);
+}
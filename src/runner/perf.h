@@ -0,0 +1,69 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "aoc/types.h"
+
+/* Hardware events counted by AocPerf. */
+typedef enum {
+    AOC_PERF_CYCLES,
+    AOC_PERF_INSTRUCTIONS,
+    AOC_PERF_BRANCHES,
+    AOC_PERF_BRANCH_MISSES,
+    AOC_PERF_L1D_MISSES, /* L1 data cache read misses */
+    AOC_PERF_LLC_MISSES, /* last level cache misses */
+    AOC_PERF_EVENT_COUNT,
+} AocPerfEvent;
+
+/* Event counts; an event which could not be counted is not `valid`. */
+typedef struct {
+    u64 value[AOC_PERF_EVENT_COUNT];
+    bool valid[AOC_PERF_EVENT_COUNT];
+} AocPerfCounts;
+
+/**
+ * Hardware performance counters (perf_event_open(2)) of the calling thread,
+ * user space only.
+ */
+typedef struct AocPerf AocPerf;
+
+/**
+ * Opens the counters of the calling thread. Events which the CPU or the
+ * hypervisor does not support are skipped.
+ *
+ * @return The counters or NULL if none could be opened, e.g. because of
+ * /proc/sys/kernel/perf_event_paranoid. The reason is printed to stderr once.
+ */
+AocPerf *aoc_perf_open(void);
+
+/**
+ * Closes the counters. Suitable for use with _cleanup_().
+ */
+void aoc_perf_close(AocPerf **perf);
+
+/**
+ * Resets and starts the counters.
+ */
+void aoc_perf_start(AocPerf *perf);
+
+/**
+ * Stops the counters and adds their values to `counts`. Values are scaled
+ * up if the kernel had to multiplex the counters.
+ */
+void aoc_perf_stop(AocPerf *perf, AocPerfCounts *counts);
+
+/**
+ * Formats IPC, branch miss rate and L1d/LLC misses per thousand instructions
+ * of `counts`, e.g. "1.23 G cycles, IPC 2.31, branch misses 1.20%, L1d MPKI
+ * 3.40, LLC MPKI 0.10". Ratios of events which were not counted are left out.
+ */
+void aoc_perf_format(const AocPerfCounts *counts, char *out, size_t out_size);
@@ -0,0 +1,35 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+
+#include "runner.h"
+
+void aoc_format_duration(u64 ns, char *out, size_t out_size) {
+    if (ns < 1000) {
+        snprintf(out, out_size, "%lu ns", ns);
+    } else if (ns < 1000000) {
+        snprintf(out, out_size, "%.1f µs", ns / 1e3);
+    } else if (ns < 1000000000) {
+        snprintf(out, out_size, "%.2f ms", ns / 1e6);
+    } else {
+        snprintf(out, out_size, "%.2f s", ns / 1e9);
+    }
+}
+
+void aoc_format_bytes(u64 bytes, char *out, size_t out_size) {
+    if (bytes < 1024) {
+        snprintf(out, out_size, "%lu B", bytes);
+    } else if (bytes < 1024 * 1024) {
+        snprintf(out, out_size, "%.1f KiB", bytes / 1024.0);
+    } else if (bytes < 1024 * 1024 * 1024) {
+        snprintf(out, out_size, "%.2f MiB", bytes / (1024.0 * 1024));
+    } else {
+        snprintf(out, out_size, "%.2f GiB", bytes / (1024.0 * 1024 * 1024));
+    }
+}
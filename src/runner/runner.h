@@ -0,0 +1,25 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#include "aoc/types.h"
+
+/**
+ * Formats a duration given in nanoseconds in a human-friendly way, e.g.
+ * "276 µs" or "1.40 s".
+ */
+void aoc_format_duration(u64 ns, char *out, size_t out_size);
+
+/**
+ * Formats a size given in bytes in a human-friendly way, e.g. "512 B" or
+ * "1.50 MiB".
+ */
+void aoc_format_bytes(u64 bytes, char *out, size_t out_size);
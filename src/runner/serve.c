@@ -0,0 +1,266 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * The main thread accepts connections and waits for requests with epoll.
+ * It reads each request without blocking into a buffer of its connection, so
+ * a slow or stalled client cannot hold up anyone else. Connections are
+ * registered with EPOLLONESHOT: once a request is complete, the connection is
+ * handed to the pool, whose worker solves it, answers and re-arms the
+ * connection. So a connection is served by at most one worker at a time and
+ * its responses stay in order, while many connections are served in parallel.
+ */
+
+#include <errno.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "aoc/io.h"
+#include "aoc/macros.h"
+#include "aoc/pool.h"
+#include "aoc/time.h"
+#include "days.h"
+#include "serve.h"
+
+#define MAX_EVENTS 64
+
+/* A stalled client may block a worker writing a response for at most this long. */
+#define SEND_TIMEOUT_S 5
+
+typedef struct {
+    int epoll_fd;
+    AocBuffer *buffers; /* one per worker, for the inputs of path requests */
+    u64 requests;       /* number of answered requests */
+} Server;
+
+typedef struct {
+    Server *server;
+    int fd;
+    AocRequest request; /* header of the request being received */
+    size_t received;    /* bytes of the request, header and body, received so far */
+    AocBuffer body;
+    bool bad; /* the header is malformed, answered with AOC_RESPONSE_BAD_REQUEST */
+} Connection;
+
+static volatile sig_atomic_t stopping;
+
+static void on_signal(int _unused_ signal) { stopping = 1; }
+
+static int write_full(int fd, const void *buf, size_t size) {
+    for (size_t done = 0; done < size;) {
+        ssize_t n = send(fd, (const char *)buf + done, size - done, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1; // also on SEND_TIMEOUT_S
+        done += n;
+    }
+    return 0;
+}
+
+static void close_connection(Connection *conn) {
+    close(conn->fd); // also removes it from the epoll set
+    aoc_io_buffer_free(&conn->body);
+    free(conn);
+}
+
+static bool valid_header(const AocRequest *request) {
+    if (request->magic != AOC_SERVE_MAGIC || request->length == 0) return false;
+    switch (request->kind) {
+    case AOC_REQUEST_INPUT: return request->length <= AOC_SERVE_MAX_LENGTH;
+    case AOC_REQUEST_PATH: return request->length <= AOC_SERVE_MAX_PATH;
+    default: return false;
+    }
+}
+
+/*
+ * Reads what has arrived of the next request of `conn` without blocking.
+ * Returns 1 once the request is complete (or its header is malformed), 0 if
+ * more is to come and a negative value if the connection is to be closed.
+ */
+static int receive_request(Connection *conn) {
+    const size_t header_size = sizeof(conn->request);
+    while (1) {
+        char *dst;
+        size_t want;
+        if (conn->received < header_size) {
+            dst = (char *)&conn->request + conn->received;
+            want = header_size - conn->received;
+        } else {
+            size_t done = conn->received - header_size;
+            if (done == conn->request.length) return 1;
+            dst = conn->body.buf + done;
+            want = conn->request.length - done;
+        }
+        ssize_t n = recv(conn->fd, dst, want, MSG_DONTWAIT);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 0;
+        if (n <= 0) return -1; // closed by the client
+        conn->received += n;
+        if (conn->received == header_size) {
+            if (!valid_header(&conn->request)) {
+                conn->bad = true;
+                return 1;
+            }
+            if (aoc_io_buffer_resize(&conn->body, conn->request.length)) return -2;
+        }
+    }
+}
+
+/* Answers the complete request of `conn`. Returns 0 if the connection can be kept open. */
+static int answer_request(Connection *conn, AocBuffer *buffer) {
+    const AocRequest *request = &conn->request;
+    char *body = conn->body.buf;
+    AocResponse response = {.status = AOC_RESPONSE_OK};
+    // inputs consist of complete lines, paths must not be cut short by a '\0'
+    bool bad = conn->bad ||
+               (request->kind == AOC_REQUEST_INPUT ? body[request->length - 1] != '\n'
+                                                   : memchr(body, '\0', request->length) != NULL);
+    if (bad) {
+        response.status = AOC_RESPONSE_BAD_REQUEST;
+        write_full(conn->fd, &response, sizeof(response));
+        return -1;
+    }
+
+    char day_name[sizeof(request->day) + 1] = {0};
+    memcpy(day_name, request->day, sizeof(request->day));
+    const AocDay *day = aoc_day_find(day_name);
+    char *input = body;
+    size_t input_size = request->length;
+    if (day == NULL) {
+        response.status = AOC_RESPONSE_UNKNOWN_DAY;
+    } else if (request->kind == AOC_REQUEST_PATH) {
+        if (aoc_io_read_into(body, buffer) || buffer->size == 0 || buffer->buf[buffer->size - 1] != '\n') {
+            response.status = AOC_RESPONSE_INPUT_ERROR;
+        }
+        input = buffer->buf;
+        input_size = buffer->size;
+    }
+    if (response.status == AOC_RESPONSE_OK) {
+        Solution solution = {0};
+        u64 start = aoc_time_now_ns();
+        day->solve(input, input_size, &solution);
+        response.solve_ns = aoc_time_now_ns() - start;
+        memcpy(response.part1, solution.part1, sizeof(response.part1));
+        memcpy(response.part2, solution.part2, sizeof(response.part2));
+    }
+    return write_full(conn->fd, &response, sizeof(response));
+}
+
+static void serve_connection(void *arg, int worker) {
+    Connection *conn = arg;
+    Server *server = conn->server;
+    if (answer_request(conn, &server->buffers[worker]) == 0) {
+        __atomic_fetch_add(&server->requests, 1, __ATOMIC_RELAXED);
+        conn->received = 0;
+        struct epoll_event event = {.events = EPOLLIN | EPOLLONESHOT, .data.ptr = conn};
+        if (epoll_ctl(server->epoll_fd, EPOLL_CTL_MOD, conn->fd, &event) == 0) return;
+    }
+    close_connection(conn);
+}
+
+/* Called by the main thread when `conn` is readable. */
+static void on_readable(Connection *conn, AocPool *pool) {
+    int status = receive_request(conn);
+    if (status > 0) {
+        aoc_pool_submit(pool, serve_connection, conn);
+        return;
+    }
+    struct epoll_event event = {.events = EPOLLIN | EPOLLONESHOT, .data.ptr = conn};
+    if (status < 0 || epoll_ctl(conn->server->epoll_fd, EPOLL_CTL_MOD, conn->fd, &event)) close_connection(conn);
+}
+
+static int listen_on(const char *path) {
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "serve: socket path too long: %s\n", path);
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        perror("serve: socket");
+        return -1;
+    }
+    unlink(path); // a stale socket of an earlier run
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) || listen(fd, SOMAXCONN)) {
+        fprintf(stderr, "serve: failed to listen on %s: %s\n", path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int aoc_serve(const char *path, int threads) {
+    int listen_fd = listen_on(path);
+    if (listen_fd < 0) return -1;
+
+    Server server = {.epoll_fd = epoll_create1(EPOLL_CLOEXEC)};
+    struct epoll_event event = {.events = EPOLLIN, .data.ptr = NULL};
+    if (server.epoll_fd < 0 || epoll_ctl(server.epoll_fd, EPOLL_CTL_ADD, listen_fd, &event)) {
+        perror("serve: epoll");
+        close(listen_fd);
+        return -1;
+    }
+
+    // no SA_RESTART, so that epoll_wait() returns
+    struct sigaction action = {.sa_handler = on_signal};
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    AocPool *pool = aoc_pool_create(threads);
+    if (pool == NULL) abort();
+    int workers = aoc_pool_size(pool);
+    server.buffers = calloc(workers, sizeof(AocBuffer));
+    if (server.buffers == NULL) abort();
+    fprintf(stderr, "serving %zu days on %s with %d workers\n", aoc_days_count, path, workers);
+
+    struct epoll_event events[MAX_EVENTS];
+    while (!stopping) {
+        int count = epoll_wait(server.epoll_fd, events, MAX_EVENTS, -1);
+        if (count < 0 && errno == EINTR) continue;
+        if (count < 0) {
+            perror("serve: epoll_wait");
+            break;
+        }
+        for (int i = 0; i < count; i++) {
+            if (events[i].data.ptr != NULL) {
+                on_readable(events[i].data.ptr, pool);
+                continue;
+            }
+            int fd = accept4(listen_fd, NULL, NULL, SOCK_CLOEXEC);
+            if (fd < 0) continue;
+            struct timeval timeout = {.tv_sec = SEND_TIMEOUT_S};
+            setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+            Connection *conn = malloc(sizeof(*conn));
+            if (conn == NULL) abort();
+            *conn = (Connection){.server = &server, .fd = fd};
+            struct epoll_event conn_event = {.events = EPOLLIN | EPOLLONESHOT, .data.ptr = conn};
+            if (epoll_ctl(server.epoll_fd, EPOLL_CTL_ADD, fd, &conn_event)) {
+                close(fd);
+                free(conn);
+            }
+        }
+    }
+
+    // requests in flight are finished; idle connections are closed by exiting
+    close(listen_fd);
+    unlink(path);
+    aoc_pool_destroy(&pool);
+    fprintf(stderr, "served %lu requests\n", server.requests);
+    for (int i = 0; i < workers; i++) aoc_io_buffer_free(&server.buffers[i]);
+    free(server.buffers);
+    close(server.epoll_fd);
+    return 0;
+}
@@ -0,0 +1,65 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "aoc/types.h"
+#include "solve.h"
+
+/*
+ * Protocol of `aoc --serve`: a client connects to the Unix domain socket and
+ * sends any number of requests, each an AocRequest followed by `length`
+ * bytes, the input itself or the path of an input file. An input must not be
+ * empty and must end with '\n'. The server answers every request with an
+ * AocResponse, in order. All integers are in host byte order, client and
+ * server run on the same machine.
+ */
+
+#define AOC_SERVE_MAGIC 0x31434f41u /* "AOC1" */
+
+/* Largest input accepted in a request. */
+#define AOC_SERVE_MAX_LENGTH (256u << 20)
+
+/* Longest path accepted in a request, in bytes. */
+#define AOC_SERVE_MAX_PATH 4095u
+
+typedef enum {
+    AOC_REQUEST_INPUT, /* the input follows */
+    AOC_REQUEST_PATH,  /* the path of the input follows, relative to the working directory of the server */
+} AocRequestKind;
+
+typedef struct {
+    u32 magic;   /* AOC_SERVE_MAGIC */
+    u32 kind;    /* AocRequestKind */
+    char day[8]; /* e.g. "day01" or "1", padded with '\0' */
+    u64 length;  /* number of bytes following the request */
+} AocRequest;
+
+typedef enum {
+    AOC_RESPONSE_OK,
+    AOC_RESPONSE_BAD_REQUEST, /* the connection is closed after this response */
+    AOC_RESPONSE_UNKNOWN_DAY,
+    AOC_RESPONSE_INPUT_ERROR, /* the input file could not be read */
+} AocResponseStatus;
+
+typedef struct {
+    u32 status;   /* AocResponseStatus */
+    u32 reserved;
+    u64 solve_ns; /* time spent in solve() */
+    char part1[sizeof(((Solution *)0)->part1)];
+    char part2[sizeof(((Solution *)0)->part2)];
+} AocResponse;
+
+/**
+ * Serves solve requests on the Unix domain socket `path` with `threads`
+ * workers (one per online CPU if not positive) until SIGINT or SIGTERM.
+ *
+ * @return 0 on a clean shutdown, a negative value if the socket could not be
+ * set up.
+ */
+int aoc_serve(const char *path, int threads);
@@ -0,0 +1,42 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "stats.h"
+
+#define SORT_NAME u64
+#define SORT_TYPE u64
+#include "sort.h"
+
+static inline u64 percentile(const u64 sorted[], size_t count, double p) {
+    size_t rank = (size_t)ceil(p * count);
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+void aoc_stats_compute(u64 samples[], size_t count, AocStats *out) {
+    memset(out, 0, sizeof(*out));
+    if (count == 0) return;
+
+    u64_quick_sort(samples, count);
+
+    u64 sum = 0;
+    for (size_t i = 0; i < count; i++) { sum += samples[i]; }
+    double mean = (double)sum / count;
+    double variance = 0;
+    for (size_t i = 0; i < count; i++) { variance += (samples[i] - mean) * (samples[i] - mean); }
+
+    out->count = count;
+    out->min = samples[0];
+    out->median = percentile(samples, count, 0.5);
+    out->p99 = percentile(samples, count, 0.99);
+    out->max = samples[count - 1];
+    out->mean = (u64)mean;
+    out->stddev = count > 1 ? sqrt(variance / (count - 1)) : 0;
+}
@@ -0,0 +1,32 @@
+/*
+ * Author: Michael Adler
+ *
+ * Copyright: 2023 Michael Adler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#include "aoc/types.h"
+
+/* Summary of a series of timing samples (all values in nanoseconds). */
+typedef struct {
+    size_t count;
+    u64 min;
+    u64 median;
+    u64 p99;
+    u64 max;
+    u64 mean;
+    double stddev;
+} AocStats;
+
+/**
+ * Computes summary statistics of `count` samples. Percentiles use the
+ * nearest-rank method.
+ *
+ * @note `samples` is sorted in place.
+ */
+void aoc_stats_compute(u64 samples[], size_t count, AocStats *out);